@@ -0,0 +1,276 @@
+#ifndef ESUTILS_BENCH_HPP
+#define ESUTILS_BENCH_HPP
+
+/**
+ * @file bench.hpp
+ * A minimal header-only microbenchmark harness: throughput and percentiles of the time per operation, baselines for
+ * regression checks
+ * @author Etienne Santoul
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace esutils::bench
+{
+  /**
+   * @brief Prevents the compiler from optimizing away the computation of a value
+   */
+  template <typename T>
+  inline void do_not_optimize(const T &value)
+  {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  /**
+   * @brief Forces the compiler to assume that any memory may have been read or written
+   */
+  inline void clobber_memory()
+  {
+    asm volatile("" : : : "memory");
+  }
+
+  /**
+   * @brief A benchmark body: runs the measured operation count times
+   */
+  using Body = std::function<void(size_t count)>;
+
+  /**
+   * @brief A benchmark: the factory sets up the data once and returns the body, so that the setup is not measured
+   */
+  struct Benchmark
+  {
+    std::string name;
+    std::function<Body()> factory;
+  };
+
+  struct Result
+  {
+    std::string name;
+    double opsPerSecond = 0;
+    // Percentiles of the mean time per operation of the batches, in nanoseconds. A batch lasts at least 20 us, so
+    // these are not the latencies of single operations: an outlier operation is averaged over its batch
+    double p50 = 0;
+    double p99 = 0;
+  };
+
+  struct Options
+  {
+    std::string filter;
+    double minTimeMs = 200;
+    std::string baseline;
+    std::string save;
+    double threshold = 10; // Tolerated throughput loss against the baseline, in percent
+    bool list = false;
+  };
+
+  /**
+   * @return the registered benchmarks, in their registration order
+   */
+  inline std::vector<Benchmark> &registry()
+  {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+  }
+
+  /**
+   * @brief Registers a benchmark
+   * @param name a unique name, by convention "group/variant/parameters"
+   * @param factory a callable returning the Body of the benchmark
+   */
+  template <typename Factory>
+  void add(std::string name, Factory factory)
+  {
+    registry().push_back({std::move(name), [factory]() -> Body { return factory(); }});
+  }
+
+  /**
+   * @brief Measures a benchmark. The body runs in samples of a batch of operations long enough for the clock
+   * resolution, the percentiles are those of the mean time per operation of the samples
+   */
+  inline Result run(const Benchmark &benchmark, double minTimeMs)
+  {
+    using clock = std::chrono::steady_clock;
+    const Body body = benchmark.factory();
+
+    const auto time = [&body](size_t count) {
+      const auto begin = clock::now();
+      body(count);
+      clobber_memory();
+      return std::chrono::duration<double, std::nano>(clock::now() - begin).count();
+    };
+
+    // Batches of at least 20 us, measured after a warm up
+    size_t batch = 1;
+    while (time(batch) < 20e3 && batch < (size_t{1} << 30))
+      batch *= 2;
+
+    std::vector<double> samples;
+    double total = 0;
+    while ((total < minTimeMs * 1e6 || samples.size() < 10) && samples.size() < 100000)
+    {
+      const double elapsed = time(batch);
+      total += elapsed;
+      samples.push_back(elapsed / static_cast<double>(batch));
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&samples](double p) {
+      return samples[std::min(samples.size() - 1, static_cast<size_t>(p * static_cast<double>(samples.size())))];
+    };
+    Result result;
+    result.name = benchmark.name;
+    result.opsPerSecond = static_cast<double>(batch) * static_cast<double>(samples.size()) / (total * 1e-9);
+    result.p50 = percentile(0.5);
+    result.p99 = percentile(0.99);
+    return result;
+  }
+
+  /**
+   * @brief Reads a baseline file, one "name throughput" line per benchmark
+   */
+  inline std::map<std::string, double> load_baseline(const std::string &path)
+  {
+    std::map<std::string, double> baseline;
+    if (FILE *file = std::fopen(path.c_str(), "r"))
+    {
+      char name[256];
+      double opsPerSecond;
+      while (std::fscanf(file, "%255s %lf", name, &opsPerSecond) == 2)
+        baseline[name] = opsPerSecond;
+      std::fclose(file);
+    }
+    return baseline;
+  }
+
+  inline bool save_baseline(const std::string &path, const std::vector<Result> &results)
+  {
+    FILE *file = std::fopen(path.c_str(), "w");
+    if (!file)
+      return false;
+    for (const Result &result : results)
+      std::fprintf(file, "%s %.6g\n", result.name.c_str(), result.opsPerSecond);
+    std::fclose(file);
+    return true;
+  }
+
+  inline void usage(const char *program)
+  {
+    std::printf("Usage: %s [options]\n"
+                "  --filter TEXT      only run the benchmarks whose name contains TEXT\n"
+                "  --min-time MS      minimal measurement time per benchmark (default 200)\n"
+                "  --save FILE        write the throughputs to FILE, to be used as a baseline\n"
+                "  --baseline FILE    compare the throughputs with FILE\n"
+                "  --threshold PCT    fail when a throughput is more than PCT%% below the baseline (default 10)\n"
+                "  --list             list the benchmarks\n",
+                program);
+  }
+
+  /**
+   * @brief Parses the command line
+   * @return false if the command line is invalid
+   */
+  inline bool parse(int argc, char **argv, Options &options)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      const auto value = [&]() -> const char * { return i + 1 < argc ? argv[++i] : nullptr; };
+      const char *arg = argv[i];
+      const char *v = nullptr;
+      if (std::strcmp(arg, "--list") == 0)
+        options.list = true;
+      else if (std::strcmp(arg, "--filter") == 0 && (v = value()))
+        options.filter = v;
+      else if (std::strcmp(arg, "--min-time") == 0 && (v = value()))
+        options.minTimeMs = std::atof(v);
+      else if (std::strcmp(arg, "--save") == 0 && (v = value()))
+        options.save = v;
+      else if (std::strcmp(arg, "--baseline") == 0 && (v = value()))
+        options.baseline = v;
+      else if (std::strcmp(arg, "--threshold") == 0 && (v = value()))
+        options.threshold = std::atof(v);
+      else
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Runs the registered benchmarks according to the command line and prints a report
+   * @return the exit code of the program: 0 on success, 1 if a benchmark regressed, 2 on invalid arguments
+   */
+  inline int main(int argc, char **argv)
+  {
+    Options options;
+    if (!parse(argc, argv, options))
+    {
+      usage(argv[0]);
+      return 2;
+    }
+
+    const std::map<std::string, double> baseline =
+      options.baseline.empty() ? std::map<std::string, double>{} : load_baseline(options.baseline);
+    if (!options.baseline.empty() && baseline.empty())
+    {
+      std::fprintf(stderr, "Cannot read the baseline %s\n", options.baseline.c_str());
+      return 2;
+    }
+
+    std::vector<Result> results;
+    size_t regressions = 0;
+    if (!options.list)
+    {
+      std::printf("p50 and p99: percentiles over batches of at least 20 us of the mean ns per operation\n");
+      std::printf("%-64s %12s %10s %10s %9s\n", "benchmark", "Mops/s", "batch p50", "batch p99", "vs base");
+    }
+    for (const Benchmark &benchmark : registry())
+    {
+      if (benchmark.name.find(options.filter) == std::string::npos)
+        continue;
+      if (options.list)
+      {
+        std::printf("%s\n", benchmark.name.c_str());
+        continue;
+      }
+
+      const Result result = run(benchmark, options.minTimeMs);
+      results.push_back(result);
+      std::printf("%-64s %12.2f %10.2f %10.2f", result.name.c_str(), result.opsPerSecond * 1e-6, result.p50,
+                  result.p99);
+      const auto reference = baseline.find(result.name);
+      if (reference != baseline.end())
+      {
+        const double change = (result.opsPerSecond / reference->second - 1) * 100;
+        const bool regressed = change < -options.threshold;
+        regressions += regressed;
+        std::printf(" %+8.1f%%%s", change, regressed ? "  REGRESSION" : "");
+      }
+      std::printf("\n");
+      std::fflush(stdout);
+    }
+
+    if (!options.save.empty() && !save_baseline(options.save, results))
+    {
+      std::fprintf(stderr, "Cannot write the baseline %s\n", options.save.c_str());
+      return 2;
+    }
+    if (regressions)
+    {
+      std::printf("%zu benchmark(s) more than %.1f%% slower than the baseline\n", regressions, options.threshold);
+      return 1;
+    }
+    return 0;
+  }
+} // namespace esutils::bench
+
+#endif // ESUTILS_BENCH_HPP
@@ -0,0 +1,107 @@
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "bench.hpp"
+#include "esutils/bit_slice_reference.hpp"
+#include "esutils/bool_collection.hpp"
+
+namespace
+{
+  using esutils::bench::do_not_optimize;
+
+  constexpr size_t bits = 4096;
+  constexpr size_t slices = 1024;
+
+  std::vector<uint16_t> random_indices(size_t count, size_t range)
+  {
+    std::mt19937 rng(3);
+    std::vector<uint16_t> indices(count);
+    for (auto &index : indices)
+      index = static_cast<uint16_t>(rng() % range);
+    return indices;
+  }
+
+  void add_bool_collection_benchmarks()
+  {
+    // Random toggles then a sequential count of the set bits
+    esutils::bench::add("bool_collection/esutils/toggle_random", [] {
+      auto collection = std::make_shared<esutils::BoolCollection<bits>>();
+      return [collection, indices = random_indices(1024, bits)](size_t count) {
+        for (size_t i = 0; i < count; ++i)
+        {
+          auto bit = (*collection)[indices[i & 1023]];
+          bit = !bit;
+        }
+      };
+    });
+    esutils::bench::add("bool_collection/std::vector<bool>/toggle_random", [] {
+      auto collection = std::make_shared<std::vector<bool>>(bits);
+      return [collection, indices = random_indices(1024, bits)](size_t count) {
+        for (size_t i = 0; i < count; ++i)
+        {
+          auto bit = (*collection)[indices[i & 1023]];
+          bit = !bit;
+        }
+      };
+    });
+    esutils::bench::add("bool_collection/esutils/scan", [] {
+      auto collection = std::make_shared<esutils::BoolCollection<bits>>();
+      for (uint16_t index : random_indices(bits / 2, bits))
+        (*collection)[index] = true;
+      return [collection](size_t count) {
+        size_t set = 0;
+        for (size_t i = 0; i < count; ++i)
+          set += (*collection)[i & (bits - 1)];
+        do_not_optimize(set);
+      };
+    });
+    esutils::bench::add("bool_collection/std::vector<bool>/scan", [] {
+      auto collection = std::make_shared<std::vector<bool>>(bits);
+      for (uint16_t index : random_indices(bits / 2, bits))
+        (*collection)[index] = true;
+      return [collection](size_t count) {
+        size_t set = 0;
+        for (size_t i = 0; i < count; ++i)
+          set += (*collection)[i & (bits - 1)];
+        do_not_optimize(set);
+      };
+    });
+  }
+
+  // Increments packed slices: 4 bits slices stay inside a word, 5 bits slices straddle words
+  template <size_t sliceSize>
+  void add_bit_slice_benchmark()
+  {
+    esutils::bench::add("bit_slice_reference/esutils/increment/slice=" + std::to_string(sliceSize), [] {
+      auto words = std::make_shared<std::vector<uint32_t>>((slices * sliceSize + 31) / 32);
+      return [words, indices = random_indices(1024, slices)](size_t count) {
+        for (size_t i = 0; i < count; ++i)
+        {
+          esutils::BitSliceReference<sliceSize, uint8_t, uint32_t> slice(words->data(), indices[i & 1023]);
+          slice = static_cast<uint8_t>(slice + 1);
+        }
+        esutils::bench::clobber_memory();
+      };
+    });
+    esutils::bench::add("bit_slice_reference/std::vector<uint8_t>/increment/slice=" + std::to_string(sliceSize), [] {
+      auto bytes = std::make_shared<std::vector<uint8_t>>(slices);
+      return [bytes, indices = random_indices(1024, slices)](size_t count) {
+        for (size_t i = 0; i < count; ++i)
+        {
+          uint8_t &slice = (*bytes)[indices[i & 1023]];
+          slice = static_cast<uint8_t>((slice + 1) & ((1u << sliceSize) - 1));
+        }
+        esutils::bench::clobber_memory();
+      };
+    });
+  }
+}
+
+void add_bit_benchmarks()
+{
+  add_bool_collection_benchmarks();
+  add_bit_slice_benchmark<4>();
+  add_bit_slice_benchmark<5>();
+}
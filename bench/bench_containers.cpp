@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "bench.hpp"
+#include "esutils/ring_buffer.hpp"
+#include "esutils/static_set.hpp"
+#include "esutils/static_stack.hpp"
+
+namespace
+{
+  using esutils::bench::do_not_optimize;
+
+  constexpr size_t capacity = 1024;
+  constexpr double fillFactors[] = {0.25, 0.5, 0.9};
+
+  std::string percent(double fill)
+  {
+    return std::to_string(static_cast<int>(fill * 100)) + "%";
+  }
+
+  // Steady state at a given fill level: each operation adds an element and removes the oldest one
+  void add_ring_buffer_benchmarks()
+  {
+    for (double fill : fillFactors)
+    {
+      const size_t level = static_cast<size_t>(fill * capacity);
+      esutils::bench::add("ring_buffer/esutils/write_read/fill=" + percent(fill), [level] {
+        auto buffer = std::make_shared<esutils::RingBuffer<uint32_t, capacity>>();
+        for (uint32_t i = 0; i < level; ++i)
+          buffer->write(i);
+        return [buffer](size_t count) {
+          for (size_t i = 0; i < count; ++i)
+          {
+            buffer->write(static_cast<uint32_t>(i));
+            do_not_optimize(buffer->read());
+          }
+        };
+      });
+      esutils::bench::add("ring_buffer/std::deque/write_read/fill=" + percent(fill), [level] {
+        auto deque = std::make_shared<std::deque<uint32_t>>(level);
+        return [deque](size_t count) {
+          for (size_t i = 0; i < count; ++i)
+          {
+            deque->push_back(static_cast<uint32_t>(i));
+            do_not_optimize(deque->front());
+            deque->pop_front();
+          }
+        };
+      });
+    }
+  }
+
+  void add_static_stack_benchmarks()
+  {
+    for (double fill : fillFactors)
+    {
+      const size_t level = static_cast<size_t>(fill * capacity);
+      esutils::bench::add("static_stack/esutils/push_pop/fill=" + percent(fill), [level] {
+        auto stack = std::make_shared<esutils::StaticStack<uint32_t, capacity>>();
+        for (uint32_t i = 0; i < level; ++i)
+          stack->push(i);
+        return [stack](size_t count) {
+          for (size_t i = 0; i < count; ++i)
+          {
+            stack->push(static_cast<uint32_t>(i));
+            do_not_optimize(stack->pop());
+          }
+        };
+      });
+      esutils::bench::add("static_stack/std::vector/push_pop/fill=" + percent(fill), [level] {
+        auto vector = std::make_shared<std::vector<uint32_t>>(level);
+        vector->reserve(capacity);
+        return [vector](size_t count) {
+          for (size_t i = 0; i < count; ++i)
+          {
+            vector->push_back(static_cast<uint32_t>(i));
+            do_not_optimize(vector->back());
+            vector->pop_back();
+          }
+        };
+      });
+      esutils::bench::add("static_stack/esutils/find/fill=" + percent(fill), [level] {
+        auto stack = std::make_shared<esutils::StaticStack<uint32_t, capacity>>();
+        for (uint32_t i = 0; i < level; ++i)
+          stack->push(i);
+        return [stack, level](size_t count) {
+          for (size_t i = 0; i < count; ++i)
+            do_not_optimize(stack->find(static_cast<uint32_t>(i % level)));
+        };
+      });
+      esutils::bench::add("static_stack/std::vector/find/fill=" + percent(fill), [level] {
+        auto vector = std::make_shared<std::vector<uint32_t>>(level);
+        std::iota(vector->begin(), vector->end(), 0u);
+        return [vector, level](size_t count) {
+          for (size_t i = 0; i < count; ++i)
+            do_not_optimize(std::find(vector->begin(), vector->end(), static_cast<uint32_t>(i % level)));
+        };
+      });
+    }
+  }
+
+  enum class Distribution
+  {
+    SEQUENTIAL,
+    UNIFORM,
+    STRIDED, // Multiples of 32: they share their low bits, the worst case of a masking hash
+  };
+
+  const char *name(Distribution distribution)
+  {
+    switch (distribution)
+    {
+    case Distribution::SEQUENTIAL:
+      return "sequential";
+    case Distribution::UNIFORM:
+      return "uniform";
+    default:
+      return "strided";
+    }
+  }
+
+  // count distinct keys, the lookups query all of them while only the first half is inserted
+  std::vector<uint16_t> make_keys(Distribution distribution, size_t count)
+  {
+    std::vector<uint16_t> keys(65536);
+    std::iota(keys.begin(), keys.end(), uint16_t{0});
+    if (distribution == Distribution::UNIFORM)
+      std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+    else if (distribution == Distribution::STRIDED)
+      std::transform(keys.begin(), keys.end(), keys.begin(), [](uint16_t k) { return static_cast<uint16_t>(k * 32); });
+    keys.resize(count);
+    return keys;
+  }
+
+  std::vector<uint16_t> shuffled(std::vector<uint16_t> keys)
+  {
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(2));
+    return keys;
+  }
+
+  void add_static_set_benchmarks()
+  {
+    using Set = esutils::StaticSet<uint16_t, capacity>;
+    for (Distribution distribution : {Distribution::SEQUENTIAL, Distribution::UNIFORM, Distribution::STRIDED})
+    {
+      for (double fill : {0.5, 0.9})
+      {
+        const size_t level = static_cast<size_t>(fill * capacity);
+        const std::vector<uint16_t> keys = make_keys(distribution, 2 * level);
+        const std::string suffix = std::string("/keys=") + name(distribution) + "/fill=" + percent(fill);
+
+        // Half of the lookups hit
+        esutils::bench::add("static_set/esutils/find" + suffix, [keys, level] {
+          auto set = std::make_shared<Set>();
+          for (size_t i = 0; i < level; ++i)
+            set->insert(keys[i]);
+          return [set, queries = shuffled(keys)](size_t count) {
+            for (size_t i = 0, j = 0; i < count; ++i, j = j + 1 == queries.size() ? 0 : j + 1)
+              do_not_optimize(set->find(queries[j]) != set->end());
+          };
+        });
+        esutils::bench::add("static_set/std::unordered_set/find" + suffix, [keys, level] {
+          auto set = std::make_shared<std::unordered_set<uint16_t>>(keys.begin(), keys.begin() + level);
+          return [set, queries = shuffled(keys)](size_t count) {
+            for (size_t i = 0, j = 0; i < count; ++i, j = j + 1 == queries.size() ? 0 : j + 1)
+              do_not_optimize(set->find(queries[j]) != set->end());
+          };
+        });
+
+        // Fills an emptied set up to the fill factor again and again, the cost of emptying it is included
+        esutils::bench::add("static_set/esutils/insert" + suffix, [keys, level] {
+          auto set = std::make_shared<Set>();
+          return [set, keys, level](size_t count) {
+            for (size_t i = 0, j = level; i < count; ++i, ++j)
+            {
+              if (j == level)
+              {
+                set->clear();
+                j = 0;
+              }
+              do_not_optimize(set->insert(keys[j]));
+            }
+          };
+        });
+        esutils::bench::add("static_set/std::unordered_set/insert" + suffix, [keys, level] {
+          auto set = std::make_shared<std::unordered_set<uint16_t>>();
+          set->reserve(capacity);
+          return [set, keys, level](size_t count) {
+            for (size_t i = 0, j = level; i < count; ++i, ++j)
+            {
+              if (j == level)
+              {
+                set->clear();
+                j = 0;
+              }
+              do_not_optimize(set->insert(keys[j]));
+            }
+          };
+        });
+      }
+    }
+  }
+}
+
+void add_container_benchmarks()
+{
+  add_ring_buffer_benchmarks();
+  add_static_stack_benchmarks();
+  add_static_set_benchmarks();
+}
@@ -0,0 +1,78 @@
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "bench.hpp"
+#include "esutils/lookup_table.hpp"
+
+namespace
+{
+  using esutils::bench::do_not_optimize;
+
+  constexpr size_t entries = 1024;
+
+  float sine(size_t i)
+  {
+    return std::sin(static_cast<float>(i) * 6.2831853f / entries);
+  }
+
+  std::vector<uint16_t> random_indices(size_t count)
+  {
+    std::mt19937 rng(4);
+    std::vector<uint16_t> indices(count);
+    for (auto &index : indices)
+      index = static_cast<uint16_t>(rng() % entries);
+    return indices;
+  }
+
+  const esutils::LookUpTable<float, entries> &table()
+  {
+    static const esutils::LookUpTable<float, entries> lut(sine);
+    return lut;
+  }
+}
+
+void add_lookup_table_benchmarks()
+{
+  esutils::bench::add("lookup_table/esutils/index", [] {
+    return [lut = &table(), indices = random_indices(4096)](size_t count) {
+      float sum = 0;
+      for (size_t i = 0; i < count; ++i)
+        sum += (*lut)[indices[i & 4095]];
+      do_not_optimize(sum);
+    };
+  });
+  esutils::bench::add("lookup_table/std::vector/index", [] {
+    auto values = std::make_shared<std::vector<float>>(entries);
+    for (size_t i = 0; i < entries; ++i)
+      (*values)[i] = sine(i);
+    return [values, indices = random_indices(4096)](size_t count) {
+      float sum = 0;
+      for (size_t i = 0; i < count; ++i)
+        sum += (*values)[indices[i & 4095]];
+      do_not_optimize(sum);
+    };
+  });
+  esutils::bench::add("lookup_table/std::sin/compute", [] {
+    return [indices = random_indices(4096)](size_t count) {
+      float sum = 0;
+      for (size_t i = 0; i < count; ++i)
+        sum += sine(indices[i & 4095]);
+      do_not_optimize(sum);
+    };
+  });
+
+  // One operation is one element of a block of 256
+  esutils::bench::add("lookup_table/esutils/transform", [] {
+    auto out = std::make_shared<std::vector<float>>(256);
+    return [lut = &table(), out, indices = random_indices(4096)](size_t count) {
+      for (size_t i = 0; i < count; i += 256)
+      {
+        lut->transform(indices.data() + (i & 4095), out->data(), 256);
+        esutils::bench::clobber_memory();
+      }
+    };
+  });
+}
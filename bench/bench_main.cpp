@@ -0,0 +1,13 @@
+#include "bench.hpp"
+
+void add_bit_benchmarks();
+void add_container_benchmarks();
+void add_lookup_table_benchmarks();
+
+int main(int argc, char **argv)
+{
+  add_container_benchmarks();
+  add_bit_benchmarks();
+  add_lookup_table_benchmarks();
+  return esutils::bench::main(argc, argv);
+}
@@ -7,8 +7,11 @@
  * @author Etienne Santoul
  */
 
+#include <cstddef>
 #include <cstdint>
 #include <array>
+#include <limits>
+#include <type_traits>
 
 namespace esutils
 {
@@ -16,14 +19,52 @@ namespace esutils
    * @brief Generates values of the polynomia a/2 * x^2 + (1-a/2) * x.
    * This function is meant to be used for values in the range [0, 1] to create nonlinearity
    * @tparam alpha is an int8_t that is used to compute a = alpha/127
-   * @tparam T type of x and of return value
+   * @tparam T type of x and of return value. An integral T is a fixed point fraction with digits(T) fractional bits
+   * (Q15 for int16_t, Q31 for int32_t, Q16 for uint16_t...) of at most 32 bits: the input range is then [0, 1[ and the
+   * evaluation only uses integer arithmetic with coefficients computed at compile time
    * @param x argument value
    */
   template <int8_t alpha, typename T>
   constexpr T curvegen(T x)
   {
-    T a = alpha / static_cast<T>(0x7F);
-    return a / static_cast<T>(2) * x * x + (static_cast<T>(1) - a / static_cast<T>(2)) * x;
+    static_assert(!std::is_integral_v<T> || sizeof(T) <= 4,
+                  "Fixed point curvegen is computed in int64_t and is limited to integers of 32 bits or less");
+    if constexpr (std::is_integral_v<T>)
+    {
+      // y = x - a/2 * x * (1 - x), with a/2 and 1 in Q(digits) and x * (1 - x) <= 1/4 so nothing overflows
+      constexpr int digits = std::numeric_limits<T>::digits;
+      using wide_t = std::conditional_t<digits <= 16, int32_t, int64_t>;
+      constexpr wide_t one = wide_t{1} << digits;
+      constexpr wide_t half = one / 2;
+      constexpr wide_t halfA = (alpha * one + (alpha < 0 ? -127 : 127)) / 254; // Rounded to nearest
+      const wide_t wx = x;
+      const wide_t product = (wx * (one - wx) + half) >> digits;
+      const wide_t y = wx - ((halfA * product + half) >> digits);
+      return static_cast<T>(y > std::numeric_limits<T>::max() ? std::numeric_limits<T>::max() : y);
+    }
+    else
+    {
+      T a = alpha / static_cast<T>(0x7F);
+      return a / static_cast<T>(2) * x * x + (static_cast<T>(1) - a / static_cast<T>(2)) * x;
+    }
+  }
+
+  /**
+   * @brief Applies curvegen to a whole buffer. The loop has no dependency between elements so that compilers
+   * vectorize it on hosts
+   * @tparam alpha is an int8_t that is used to compute a = alpha/127
+   * @tparam T type of the values, see curvegen(T)
+   * @param in the argument values
+   * @param out the array receiving the results, may be the same as in
+   * @param n the number of values
+   */
+  template <int8_t alpha, typename T>
+  constexpr void curvegen(const T *in, T *out, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      out[i] = curvegen<alpha>(in[i]);
+    }
   }
 } // namespace esutils
 
@@ -0,0 +1,218 @@
+#ifndef ESUTILS_ATOMIC_BOOL_COLLECTION_HPP
+#define ESUTILS_ATOMIC_BOOL_COLLECTION_HPP
+
+/**
+ * @file atomic_bool_collection.hpp
+ * Definition of an array of bool optimised in terms of space whose bits can be safely
+ * modified concurrently (threads, interrupt service routines) without critical sections
+ * @author Etienne Santoul
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "bit_operations.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief A collection of flags stored in std::atomic words.
+   * Every modification is a single atomic read-modify-write (fetch_or / fetch_and / exchange) on the word
+   * containing the bit, so concurrent modifications of different bits of the same word never get lost.
+   * Bit i is stored in word i / digits(Word) at position i % digits(Word) (LSB first).
+   * @note The operations are only interrupt-safe on targets where std::atomic<Word> is lock free
+   * (e.g. Cortex-M3 and above, not Cortex-M0)
+   * @tparam sz the number of flags in the collection
+   * @tparam Word the unsigned integer type used as atomic storage unit
+   */
+  template <size_t sz, typename Word = uint32_t>
+  class AtomicBoolCollection
+  {
+    static_assert(std::is_unsigned_v<Word>, "`Word` must be an unsigned integer type");
+
+    static constexpr size_t wordBits = std::numeric_limits<Word>::digits;
+    static constexpr size_t wordCount = (sz + wordBits - 1) / wordBits;
+
+  public:
+    /**
+     * @brief Default constructor, all flags are false
+     */
+    constexpr AtomicBoolCollection() = default;
+
+    AtomicBoolCollection(const AtomicBoolCollection &other) = delete;
+    AtomicBoolCollection &operator=(const AtomicBoolCollection &other) = delete;
+
+    /**
+     * @return the number of flags in the collection
+     */
+    constexpr size_t size() const
+    {
+      return sz;
+    }
+
+    /**
+     * @param index the index of the flag
+     * @param order the memory ordering of the load
+     * @return the value of the flag
+     */
+    bool test(size_t index, std::memory_order order = std::memory_order_seq_cst) const
+    {
+      return mData[index / wordBits].load(order) & bit_mask(index % wordBits);
+    }
+
+    /**
+     * @brief Array subscript operator
+     * @param index the index of the desired flag
+     * @return the value of the flag
+     */
+    bool operator[](size_t index) const
+    {
+      return test(index);
+    }
+
+    /**
+     * @brief Sets a flag to true
+     * @param index the index of the flag
+     * @param order the memory ordering of the read-modify-write
+     */
+    void set(size_t index, std::memory_order order = std::memory_order_seq_cst)
+    {
+      mData[index / wordBits].fetch_or(bit_mask(index % wordBits), order);
+    }
+
+    /**
+     * @brief Sets a flag to false
+     * @param index the index of the flag
+     * @param order the memory ordering of the read-modify-write
+     */
+    void reset(size_t index, std::memory_order order = std::memory_order_seq_cst)
+    {
+      mData[index / wordBits].fetch_and(clear_mask(index % wordBits), order);
+    }
+
+    /**
+     * @brief Inverts the value of a flag
+     * @param index the index of the flag
+     * @param order the memory ordering of the read-modify-write
+     */
+    void flip(size_t index, std::memory_order order = std::memory_order_seq_cst)
+    {
+      mData[index / wordBits].fetch_xor(bit_mask(index % wordBits), order);
+    }
+
+    /**
+     * @brief Sets a flag to true
+     * @param index the index of the flag
+     * @param order the memory ordering of the read-modify-write
+     * @return the value of the flag before it was set
+     */
+    bool test_and_set(size_t index, std::memory_order order = std::memory_order_seq_cst)
+    {
+      const Word mask = bit_mask(index % wordBits);
+      return mData[index / wordBits].fetch_or(mask, order) & mask;
+    }
+
+    /**
+     * @brief Sets a flag to false
+     * @param index the index of the flag
+     * @param order the memory ordering of the read-modify-write
+     * @return the value of the flag before it was reset
+     */
+    bool test_and_reset(size_t index, std::memory_order order = std::memory_order_seq_cst)
+    {
+      const Word mask = bit_mask(index % wordBits);
+      return mData[index / wordBits].fetch_and(clear_mask(index % wordBits), order) & mask;
+    }
+
+    /**
+     * @brief Atomically finds a false flag and sets it to true.
+     * Each word is claimed with a fetch_or so two concurrent callers can never get the same index.
+     * @param order the memory ordering of the successful read-modify-write
+     * @return the index of the claimed flag or sz if all the flags were already true
+     */
+    size_t claim_first_free(std::memory_order order = std::memory_order_seq_cst)
+    {
+      for (size_t w = 0; w < wordCount; ++w)
+      {
+        Word current = mData[w].load(std::memory_order_relaxed);
+        Word available = ~current & valid_mask(w);
+        while (available)
+        {
+          const int bitPos = countr_zero(available);
+          const Word mask = bit_mask(bitPos);
+          current = mData[w].fetch_or(mask, order);
+          if ((current & mask) == 0)
+          {
+            return w * wordBits + bitPos;
+          }
+          // Someone else claimed it in the meantime, retry with the updated word value
+          available = ~current & valid_mask(w);
+        }
+      }
+      return sz;
+    }
+
+    /**
+     * @brief Atomically reads and clears every flag, word by word, then calls foo with the index of each flag that was set.
+     * The whole collection is not cleared in a single atomic operation, but a flag that is set concurrently
+     * is either reported by this call or left set for the next one, never lost.
+     * @param foo a callable invoked as foo(size_t index) for every flag that was true
+     * @param order the memory ordering of the exchanges
+     * @return the number of flags that were true
+     */
+    template <typename Func>
+    size_t fetch_and_clear_all(Func &&foo, std::memory_order order = std::memory_order_seq_cst)
+    {
+      size_t count = 0;
+      for (size_t w = 0; w < wordCount; ++w)
+      {
+        Word flags = mData[w].exchange(0, order);
+        while (flags)
+        {
+          const int bitPos = countr_zero(flags);
+          flags &= flags - 1; // Clear lowest set bit
+          foo(w * wordBits + bitPos);
+          ++count;
+        }
+      }
+      return count;
+    }
+
+    /**
+     * @brief Sets every flag to false
+     * @param order the memory ordering of the stores
+     */
+    void clear(std::memory_order order = std::memory_order_seq_cst)
+    {
+      for (size_t w = 0; w < wordCount; ++w)
+      {
+        mData[w].store(0, order);
+      }
+    }
+
+  private:
+    static constexpr Word bit_mask(size_t bitPos)
+    {
+      return Word{1} << bitPos;
+    }
+
+    static constexpr Word clear_mask(size_t bitPos)
+    {
+      return ~bit_mask(bitPos);
+    }
+
+    static constexpr Word valid_mask(size_t w)
+    {
+      if (w == wordCount - 1 && sz % wordBits != 0)
+        return bit_mask(sz % wordBits) - 1;
+      return std::numeric_limits<Word>::max();
+    }
+
+    std::atomic<Word> mData[wordCount]{};
+  };
+} // namespace esutils
+
+#endif // ESUTILS_ATOMIC_BOOL_COLLECTION_HPP
@@ -0,0 +1,68 @@
+#ifndef ESUTILS_BIT_OPERATIONS_HPP
+#define ESUTILS_BIT_OPERATIONS_HPP
+
+/**
+ * @file bit_operations.hpp
+ * constexpr bit counting helpers (C++17 stand-ins for the C++20 <bit> header)
+ * @author Etienne Santoul
+ */
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace esutils
+{
+  /**
+   * @brief Counts the number of consecutive 0 bits starting from the least significant bit
+   * @tparam T an unsigned integer type
+   * @param x the value to inspect
+   * @return the number of trailing zeros, std::numeric_limits<T>::digits if x == 0
+   */
+  template <typename T>
+  constexpr int countr_zero(T x)
+  {
+    static_assert(std::is_unsigned_v<T>, "`T` must be an unsigned integer type");
+    if (x == 0)
+      return std::numeric_limits<T>::digits;
+    if constexpr (std::numeric_limits<T>::digits <= std::numeric_limits<unsigned int>::digits)
+      return __builtin_ctz(x);
+    else
+      return __builtin_ctzll(x);
+  }
+
+  /**
+   * @brief Counts the number of consecutive 0 bits starting from the most significant bit
+   * @tparam T an unsigned integer type
+   * @param x the value to inspect
+   * @return the number of leading zeros, std::numeric_limits<T>::digits if x == 0
+   */
+  template <typename T>
+  constexpr int countl_zero(T x)
+  {
+    static_assert(std::is_unsigned_v<T>, "`T` must be an unsigned integer type");
+    if (x == 0)
+      return std::numeric_limits<T>::digits;
+    if constexpr (std::numeric_limits<T>::digits <= std::numeric_limits<unsigned int>::digits)
+      return __builtin_clz(x) - (std::numeric_limits<unsigned int>::digits - std::numeric_limits<T>::digits);
+    else
+      return __builtin_clzll(x) - (std::numeric_limits<unsigned long long>::digits - std::numeric_limits<T>::digits);
+  }
+
+  /**
+   * @brief Counts the number of 1 bits
+   * @tparam T an unsigned integer type
+   * @param x the value to inspect
+   */
+  template <typename T>
+  constexpr int popcount(T x)
+  {
+    static_assert(std::is_unsigned_v<T>, "`T` must be an unsigned integer type");
+    if constexpr (std::numeric_limits<T>::digits <= std::numeric_limits<unsigned int>::digits)
+      return __builtin_popcount(x);
+    else
+      return __builtin_popcountll(x);
+  }
+} // namespace esutils
+
+#endif // ESUTILS_BIT_OPERATIONS_HPP
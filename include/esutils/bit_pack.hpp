@@ -0,0 +1,233 @@
+#ifndef ESUTILS_BIT_PACK_HPP
+#define ESUTILS_BIT_PACK_HPP
+
+/**
+ * @file bit_pack.hpp
+ * Bulk conversion between arrays of integers and packed arrays of bit slices
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "bit_slice_reference.hpp"
+
+#if (defined(__SSSE3__) || (defined(__ARM_NEON) && defined(__aarch64__))) && \
+  defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define ESUTILS_BIT_PACK_SIMD 1
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace esutils
+{
+  namespace detail
+  {
+    /**
+     * @brief Number of bits after which the packing pattern of `bits` bits slices over `wordBits` bits words repeats
+     */
+    constexpr size_t pack_period_bits(size_t bits, size_t wordBits)
+    {
+      size_t a = bits;
+      size_t b = wordBits;
+      while (b != 0)
+      {
+        const size_t t = a % b;
+        a = b;
+        b = t;
+      }
+      return bits / a * wordBits;
+    }
+
+    template <size_t bits>
+    constexpr uintmax_t slice_mask()
+    {
+      if constexpr (bits >= std::numeric_limits<uintmax_t>::digits)
+        return std::numeric_limits<uintmax_t>::max();
+      else
+        return (uintmax_t{1} << bits) - 1;
+    }
+
+    /**
+     * @brief Reads the slice starting at a compile time bit offset, all the shifts and word indices are constants
+     */
+    template <size_t bits, size_t bitOffset, typename Underlying>
+    constexpr uintmax_t extract_slice(const Underlying *src)
+    {
+      constexpr size_t wordBits = std::numeric_limits<Underlying>::digits;
+      constexpr size_t word = bitOffset / wordBits;
+      constexpr size_t shift = bitOffset % wordBits;
+
+      uintmax_t value = src[word] >> shift;
+      for (size_t i = 1; shift + bits > i * wordBits; ++i)
+      {
+        value |= static_cast<uintmax_t>(src[word + i]) << (i * wordBits - shift);
+      }
+      return value & slice_mask<bits>();
+    }
+
+    /**
+     * @brief ORs the slice at a compile time bit offset into zero initialised words
+     */
+    template <size_t bits, size_t bitOffset, typename Underlying>
+    constexpr void deposit_slice(Underlying *dst, uintmax_t value)
+    {
+      constexpr size_t wordBits = std::numeric_limits<Underlying>::digits;
+      constexpr size_t word = bitOffset / wordBits;
+      constexpr size_t shift = bitOffset % wordBits;
+
+      value &= slice_mask<bits>();
+      dst[word] |= static_cast<Underlying>(value << shift);
+      for (size_t i = 1; shift + bits > i * wordBits; ++i)
+      {
+        dst[word + i] |= static_cast<Underlying>(value >> (i * wordBits - shift));
+      }
+    }
+
+    template <size_t bits, typename Underlying, typename T, size_t... k>
+    constexpr void unpack_period(const Underlying *src, T *out, std::index_sequence<k...>)
+    {
+      ((out[k] = static_cast<T>(extract_slice<bits, k * bits>(src))), ...);
+    }
+
+    template <size_t bits, typename T, typename Underlying, size_t... k>
+    constexpr void pack_period(const T *in, Underlying *dst, std::index_sequence<k...>)
+    {
+      (deposit_slice<bits, k * bits>(dst, static_cast<uintmax_t>(in[k])), ...);
+    }
+
+#if defined(ESUTILS_BIT_PACK_SIMD)
+    /**
+     * @brief Unpacks 12 bits slices to 16 bits lanes, 8 slices (12 bytes) per iteration.
+     * Each lane gathers the 2 bytes containing its slice with a byte shuffle, then even lanes are masked
+     * and odd lanes are shifted right by 4.
+     * @return the number of unpacked slices
+     */
+    inline size_t unpack12_simd(const uint8_t *src, size_t count, uint16_t *out)
+    {
+      size_t i = 0;
+#if defined(__SSSE3__)
+      const __m128i shuffle = _mm_setr_epi8(0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11);
+      const __m128i evenLanes = _mm_setr_epi16(-1, 0, -1, 0, -1, 0, -1, 0);
+      const __m128i lowMask = _mm_set1_epi16(0x0FFF);
+      // 16 bytes are loaded for 12 used ones: stay 4 bytes away from the end of the packed data
+      for (; i + 11 <= count; i += 8)
+      {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i / 2 * 3));
+        const __m128i lanes = _mm_shuffle_epi8(bytes, shuffle);
+        const __m128i even = _mm_and_si128(_mm_and_si128(lanes, lowMask), evenLanes);
+        const __m128i odd = _mm_andnot_si128(evenLanes, _mm_srli_epi16(lanes, 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_or_si128(even, odd));
+      }
+#else
+      static constexpr uint8_t shuffleBytes[16] = {0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11};
+      static constexpr uint16_t evenLanesValues[8] = {0xFFFF, 0, 0xFFFF, 0, 0xFFFF, 0, 0xFFFF, 0};
+      const uint8x16_t shuffle = vld1q_u8(shuffleBytes);
+      const uint16x8_t evenLanes = vld1q_u16(evenLanesValues);
+      const uint16x8_t lowMask = vdupq_n_u16(0x0FFF);
+      for (; i + 11 <= count; i += 8)
+      {
+        const uint8x16_t bytes = vld1q_u8(src + i / 2 * 3);
+        const uint16x8_t lanes = vreinterpretq_u16_u8(vqtbl1q_u8(bytes, shuffle));
+        vst1q_u16(out + i, vbslq_u16(evenLanes, vandq_u16(lanes, lowMask), vshrq_n_u16(lanes, 4)));
+      }
+#endif
+      return i;
+    }
+#endif
+  } // namespace detail
+
+  /**
+   * @brief Unpacks count consecutive slices of `bits` bits (BitSliceReference / PackedArray layout) to a plain array.
+   * The slices are processed by periods of lcm(bits, digits(Underlying)) bits whose shifts and word indices are all
+   * compile time constants. On SSSE3 / AArch64 little endian hosts, 12 bits slices to 16 bits integers use a byte shuffle kernel.
+   * @tparam bits the number of bits of each slice
+   * @param src the packed data, starting with the first slice to unpack
+   * @param count the number of slices to unpack
+   * @param out the array receiving the values
+   */
+  template <size_t bits, typename Underlying, typename T>
+  constexpr void unpack(const Underlying *src, size_t count, T *out)
+  {
+    static_assert(std::is_unsigned_v<Underlying>, "Underlying must be an unsigned integer type");
+    static_assert(bits > 0 && bits <= std::numeric_limits<uintmax_t>::digits, "Unsupported slice size");
+
+    size_t i = 0;
+#if defined(ESUTILS_BIT_PACK_SIMD)
+    if constexpr (bits == 12 && std::is_integral_v<T> && sizeof(T) == 2)
+    {
+      if (!__builtin_is_constant_evaluated())
+      {
+        i = detail::unpack12_simd(reinterpret_cast<const uint8_t *>(src), count, reinterpret_cast<uint16_t *>(out));
+      }
+    }
+#endif
+
+    constexpr size_t periodBits = detail::pack_period_bits(bits, std::numeric_limits<Underlying>::digits);
+    constexpr size_t periodSlices = periodBits / bits;
+    constexpr size_t periodWords = periodBits / std::numeric_limits<Underlying>::digits;
+    // Keep the unrolled period reasonably small, longer periods are handled slice by slice
+    if constexpr (periodSlices <= 64)
+    {
+      i -= i % periodSlices; // Restart on a period boundary after the SIMD kernel
+      for (; i + periodSlices <= count; i += periodSlices)
+      {
+        detail::unpack_period<bits>(src + i / periodSlices * periodWords, out + i, std::make_index_sequence<periodSlices>{});
+      }
+    }
+
+    for (; i < count; ++i)
+    {
+      out[i] = BitSliceReference<bits, T, const Underlying>(src, static_cast<ptrdiff_t>(i));
+    }
+  }
+
+  /**
+   * @brief Packs count values to consecutive slices of `bits` bits (BitSliceReference / PackedArray layout).
+   * Whole periods of lcm(bits, digits(Underlying)) bits are built in registers and stored without reading the destination,
+   * the remaining slices are written with a read-modify-write that preserves the bits after the last slice.
+   * @tparam bits the number of bits of each slice, higher bits of the values are discarded
+   * @param in the values to be packed
+   * @param count the number of values to pack
+   * @param dst the packed data, starting with the first slice to write
+   */
+  template <size_t bits, typename T, typename Underlying>
+  constexpr void pack(const T *in, size_t count, Underlying *dst)
+  {
+    static_assert(std::is_unsigned_v<Underlying>, "Underlying must be an unsigned integer type");
+    static_assert(bits > 0 && bits <= std::numeric_limits<uintmax_t>::digits, "Unsupported slice size");
+
+    size_t i = 0;
+    constexpr size_t periodBits = detail::pack_period_bits(bits, std::numeric_limits<Underlying>::digits);
+    constexpr size_t periodSlices = periodBits / bits;
+    constexpr size_t periodWords = periodBits / std::numeric_limits<Underlying>::digits;
+    if constexpr (periodSlices <= 64)
+    {
+      for (; i + periodSlices <= count; i += periodSlices)
+      {
+        Underlying words[periodWords]{};
+        detail::pack_period<bits>(in + i, words, std::make_index_sequence<periodSlices>{});
+        Underlying *current = dst + i / periodSlices * periodWords;
+        for (size_t w = 0; w < periodWords; ++w)
+        {
+          current[w] = words[w];
+        }
+      }
+    }
+
+    for (; i < count; ++i)
+    {
+      BitSliceReference<bits, T, Underlying>(dst, static_cast<ptrdiff_t>(i)) = in[i];
+    }
+  }
+} // namespace esutils
+
+#undef ESUTILS_BIT_PACK_SIMD
+
+#endif // ESUTILS_BIT_PACK_HPP
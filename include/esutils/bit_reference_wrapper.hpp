@@ -1,6 +1,7 @@
 #ifndef ESUTILS_BIT_REFERENCE_WRAPPER_HPP
 #define ESUTILS_BIT_REFERENCE_WRAPPER_HPP
 
+#include <atomic>
 #include <cstdint>
 #include <limits>
 #include <type_traits>
@@ -26,8 +27,9 @@ namespace esutils
 
     constexpr BitReferenceWrapper &operator=(bool b)
     {
-      *pData &= ~(1 << mBitPos);    // Reset bit
-      *pData |= (1 * b) << mBitPos; // Set bit value to b
+      // Single store of the updated value, no intermediate state is ever written to *pData
+      const std::remove_cv_t<T> mask = static_cast<std::remove_cv_t<T>>(std::remove_cv_t<T>{1} << mBitPos);
+      *pData = static_cast<std::remove_cv_t<T>>((*pData & ~mask) | (b ? mask : 0));
       return *this;
     }
 
@@ -35,6 +37,102 @@ namespace esutils
     T *pData;
     uint8_t mBitPos;
   };
+
+  /**
+   * @brief Reference to a bit of an integer whose modifications are single atomic read-modify-writes
+   * (lock prefixed instruction on x86, LDREX/STREX loop on Cortex-M3 and above), so that concurrent modifications
+   * of other bits of the same integer, by threads or interrupt service routines, never get lost.
+   * @note The referenced integer must only be modified through atomic operations while it is shared
+   * @tparam T the unsigned integer type containing the bit, may be volatile qualified
+   */
+  template <typename T>
+  class AtomicBitReferenceWrapper
+  {
+    static_assert(std::is_unsigned_v<T>, "`T` must be an unsigned integer type");
+
+    using value_t = std::remove_cv_t<T>;
+
+  public:
+    constexpr AtomicBitReferenceWrapper(T &data, uint8_t bitPosition)
+      :
+      pData(&data),
+      mMask(static_cast<value_t>(value_t{1} << bitPosition))
+    {}
+
+    /**
+     * @param order the memory ordering of the load
+     * @return the value of the bit
+     */
+    bool test(std::memory_order order = std::memory_order_seq_cst) const
+    {
+      return __atomic_load_n(pData, static_cast<int>(order)) & mMask;
+    }
+
+    operator bool() const
+    {
+      return test();
+    }
+
+    AtomicBitReferenceWrapper &operator=(bool b)
+    {
+      if (b)
+        set();
+      else
+        reset();
+      return *this;
+    }
+
+    /**
+     * @brief Sets the bit to true
+     * @param order the memory ordering of the read-modify-write
+     */
+    void set(std::memory_order order = std::memory_order_seq_cst)
+    {
+      __atomic_fetch_or(pData, mMask, static_cast<int>(order));
+    }
+
+    /**
+     * @brief Sets the bit to false
+     * @param order the memory ordering of the read-modify-write
+     */
+    void reset(std::memory_order order = std::memory_order_seq_cst)
+    {
+      __atomic_fetch_and(pData, static_cast<value_t>(~mMask), static_cast<int>(order));
+    }
+
+    /**
+     * @brief Inverts the value of the bit
+     * @param order the memory ordering of the read-modify-write
+     */
+    void flip(std::memory_order order = std::memory_order_seq_cst)
+    {
+      __atomic_fetch_xor(pData, mMask, static_cast<int>(order));
+    }
+
+    /**
+     * @brief Sets the bit to true
+     * @param order the memory ordering of the read-modify-write
+     * @return the value of the bit before it was set
+     */
+    bool test_and_set(std::memory_order order = std::memory_order_seq_cst)
+    {
+      return __atomic_fetch_or(pData, mMask, static_cast<int>(order)) & mMask;
+    }
+
+    /**
+     * @brief Sets the bit to false
+     * @param order the memory ordering of the read-modify-write
+     * @return the value of the bit before it was reset
+     */
+    bool test_and_reset(std::memory_order order = std::memory_order_seq_cst)
+    {
+      return __atomic_fetch_and(pData, static_cast<value_t>(~mMask), static_cast<int>(order)) & mMask;
+    }
+
+  private:
+    T *pData;
+    value_t mMask;
+  };
 } // namespace esutils
 
 #endif // ESUTILS_BIT_REFERENCE_WRAPPER_HPP
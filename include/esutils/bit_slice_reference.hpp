@@ -3,6 +3,8 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <type_traits>
 
 namespace esutils
@@ -13,6 +15,20 @@ namespace esutils
     static_assert(std::is_integral_v<Referenced>, "Referenced must be an integral type");
     static_assert(std::is_unsigned_v<Underlying>, "Underlying must be an unsigned integer type");
 
+    static constexpr size_t underlyingBits = std::numeric_limits<Underlying>::digits;
+
+    // When the slice size divides the Underlying size (both are then powers of 2), a slice never straddles two Underlying
+    static constexpr bool singleUnderlying = underlyingBits % sliceSize == 0;
+    static constexpr size_t slicesPerUnderlying = underlyingBits / sliceSize;
+
+    static constexpr size_t log2(size_t x)
+    {
+      size_t ret = 0;
+      while (x >>= 1)
+        ++ret;
+      return ret;
+    }
+
   public:
     constexpr BitSliceReference(Underlying *ptr, ptrdiff_t offset)
       :
@@ -20,23 +36,96 @@ namespace esutils
       mOffset(offset)
     {}
 
+    constexpr BitSliceReference(const BitSliceReference &other) = default;
+
     constexpr operator Referenced() const
     {
-      Referenced ret{};
+      if constexpr (singleUnderlying)
+      {
+        return static_cast<Referenced>((underlying() >> shift()) & sliceMask());
+      }
+      else
+      {
+        // Accumulate in the widest type so that no bit is lost before being shifted to its final position
+        uintmax_t raw = 0;
+        for_each_step([&raw](Underlying *currentPtr, Underlying bitMask, ptrdiff_t currentSliceOffset) {
+          const uintmax_t masked = *currentPtr & bitMask;
+          raw |= currentSliceOffset >= 0 ? masked << currentSliceOffset : masked >> (-currentSliceOffset);
+        });
+        return static_cast<Referenced>(raw);
+      }
+    }
+
+    constexpr BitSliceReference &operator=(Referenced value)
+    {
+      if constexpr (singleUnderlying)
+      {
+        Underlying &current = underlying();
+        current = (current & ~(sliceMask() << shift())) | ((value & sliceMask()) << shift());
+      }
+      else
+      {
+        const uintmax_t raw = value;
+        for_each_step([raw](Underlying *currentPtr, Underlying bitMask, ptrdiff_t currentSliceOffset) {
+          // Inverse of the read: bring the slice bits to the position of bitMask in the current Underlying
+          const uintmax_t shifted = currentSliceOffset >= 0 ? raw >> currentSliceOffset : raw << (-currentSliceOffset);
+          *currentPtr = (*currentPtr & ~bitMask) | (shifted & bitMask);
+        });
+      }
+      return *this;
+    }
+
+    /**
+     * @brief Copies the value of the referenced slice, not the reference itself
+     */
+    constexpr BitSliceReference &operator=(const BitSliceReference &other)
+    {
+      return *this = static_cast<Referenced>(other);
+    }
+
+  private:
+    static constexpr Underlying sliceMask()
+    {
+      return std::numeric_limits<Underlying>::max() >> (underlyingBits - sliceSize);
+    }
+
+    /**
+     * @brief Single Underlying fast path: Underlying containing the slice.
+     * The arithmetic right shift floors negative offsets, no fix-up is needed.
+     */
+    constexpr Underlying &underlying() const
+    {
+      return mPtr[mOffset >> log2(slicesPerUnderlying)];
+    }
+
+    /**
+     * @brief Single Underlying fast path: position of the slice in its Underlying.
+     * The mask gives the positive remainder for negative offsets as well (two's complement).
+     */
+    constexpr size_t shift() const
+    {
+      return (static_cast<size_t>(mOffset) & (slicesPerUnderlying - 1)) * sliceSize;
+    }
+
+    /**
+     * @brief Splits the slice in the parts contained in each Underlying it spans
+     * @param foo called as foo(Underlying *currentPtr, Underlying bitMask, ptrdiff_t currentSliceOffset) for every part,
+     * currentSliceOffset being the shift that moves the masked Underlying bits to their position in the slice
+     */
+    template <typename Func>
+    constexpr void for_each_step(Func &&foo) const
+    {
       for (size_t handledBits = 0; handledBits < sliceSize;)
       {
         const size_t remainingBits = sliceSize - handledBits;
 
         const ptrdiff_t totalBitOffset = sliceSize * mOffset + handledBits;
-        const ptrdiff_t bitOffsetInCurrentUnderlying =
-          totalBitOffset % std::numeric_limits<Underlying>::digits +
-          (totalBitOffset < 0) * std::numeric_limits<Underlying>::digits; // to get a positive number
+        ptrdiff_t bitOffsetInCurrentUnderlying = totalBitOffset % std::numeric_limits<Underlying>::digits;
+        if (bitOffsetInCurrentUnderlying < 0)
+          bitOffsetInCurrentUnderlying += std::numeric_limits<Underlying>::digits; // to get a positive number
 
         const ptrdiff_t currentUnderlyingOffset =
-          totalBitOffset / std::numeric_limits<Underlying>::digits -
-          (totalBitOffset < 0 ? 1 : 0);
-
-        const auto currentPtr = mPtr + currentUnderlyingOffset;
+          (totalBitOffset - bitOffsetInCurrentUnderlying) / std::numeric_limits<Underlying>::digits;
 
         const size_t stepBits = std::min<size_t>(
           std::numeric_limits<Underlying>::digits - bitOffsetInCurrentUnderlying,
@@ -47,32 +136,69 @@ namespace esutils
           >> (std::numeric_limits<Underlying>::digits - stepBits)
           << bitOffsetInCurrentUnderlying;
 
-        const ptrdiff_t currentSliceOffset = handledBits - bitOffsetInCurrentUnderlying;
-
-        if (currentSliceOffset >= 0)
-        {
-          ret |= static_cast<Referenced>(*currentPtr & bitMask) << currentSliceOffset;
-        }
-        else
-        {
-          ret |= static_cast<Referenced>(*currentPtr & bitMask) >> (-currentSliceOffset);
-        }
+        foo(mPtr + currentUnderlyingOffset, bitMask, static_cast<ptrdiff_t>(handledBits) - bitOffsetInCurrentUnderlying);
 
         handledBits += stepBits;
       }
+    }
 
-      return ret;
+    Underlying *mPtr;
+    ptrdiff_t mOffset;
+  };
+
+  /**
+   * @brief A reference to a field of bitWidth bits starting at bit bitOffset of an Underlying array, both known at compile time.
+   * This is meant for fixed register fields: accesses compile down to a single load, shift and mask (plus a store for writes).
+   * @tparam bitOffset the position of the least significant bit of the field, counted from the LSB of ptr[0]
+   * @tparam bitWidth the number of bits of the field
+   * @tparam Referenced the integral type of the field value
+   * @tparam Underlying the unsigned integer type of the referenced storage (may be volatile)
+   */
+  template <size_t bitOffset, size_t bitWidth, typename Referenced, typename Underlying>
+  class BitFieldReference
+  {
+    static_assert(std::is_integral_v<Referenced>, "Referenced must be an integral type");
+    static_assert(std::is_unsigned_v<Underlying>, "Underlying must be an unsigned integer type");
+    static_assert(bitWidth > 0, "The field must contain at least one bit");
+
+    static constexpr size_t underlyingBits = std::numeric_limits<Underlying>::digits;
+    static constexpr size_t index = bitOffset / underlyingBits;
+    static constexpr size_t shift = bitOffset % underlyingBits;
+    static_assert(shift + bitWidth <= underlyingBits, "The field must not straddle two Underlying");
+
+  public:
+    /**
+     * @brief Mask of the field bits in its Underlying
+     */
+    static constexpr std::remove_cv_t<Underlying> mask =
+      std::numeric_limits<Underlying>::max() >> (underlyingBits - bitWidth) << shift;
+
+    constexpr BitFieldReference(Underlying *ptr) : mPtr(ptr) {}
+
+    constexpr BitFieldReference(const BitFieldReference &other) = default;
+
+    constexpr operator Referenced() const
+    {
+      return static_cast<Referenced>((mPtr[index] & mask) >> shift);
     }
 
-    constexpr BitSliceReference &operator=(Referenced &ref)
+    constexpr BitFieldReference &operator=(Referenced value)
     {
-#pragma message "TODO Implement"
+      Underlying &current = mPtr[index];
+      current = (current & ~mask) | ((static_cast<std::remove_cv_t<Underlying>>(value) << shift) & mask);
       return *this;
     }
 
+    /**
+     * @brief Copies the value of the referenced field, not the reference itself
+     */
+    constexpr BitFieldReference &operator=(const BitFieldReference &other)
+    {
+      return *this = static_cast<Referenced>(other);
+    }
+
   private:
     Underlying *mPtr;
-    ptrdiff_t mOffset;
   };
 
   // template <size_t sliceSize, typename Referenced, typename Underlying>
@@ -0,0 +1,480 @@
+#ifndef ESUTILS_BIT_STREAM_HPP
+#define ESUTILS_BIT_STREAM_HPP
+
+/**
+ * @file bit_stream.hpp
+ * Sequential reader and writer of bit fields over a byte buffer
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bit_operations.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief Order in which the bits of each byte are consumed or produced
+   */
+  enum class BitOrder
+  {
+    MSB_FIRST, // Bit 7 of each byte first, a field's most significant bit first (network order, H.264, MPEG...)
+    LSB_FIRST  // Bit 0 of each byte first, a field's least significant bit first (DEFLATE, CAN Intel signals, BitSliceReference layout)
+  };
+
+  namespace detail
+  {
+    constexpr uint64_t low_mask(size_t bits)
+    {
+      return bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+    }
+  } // namespace detail
+
+  /**
+   * @brief Reads consecutive bit fields from a byte buffer.
+   * The next bits are cached in a 64 bits accumulator that is refilled 8 bytes at a time, so reading a field
+   * is a shift and a mask. Reading past the end of the buffer returns 0 bits and sets the overrun flag.
+   * @tparam order the order of the bits in the stream
+   */
+  template <BitOrder order = BitOrder::MSB_FIRST>
+  class BitReader
+  {
+    // Number of bits that are guaranteed to be in the accumulator after a refill
+    static constexpr size_t cacheMinBits = 56;
+
+  public:
+    /**
+     * @brief Constructor
+     * @param data the buffer to read from, must outlive the reader
+     * @param size the size of the buffer in bytes
+     */
+    constexpr BitReader(const uint8_t *data, size_t size) : pData(data), mSize(size) {}
+
+    /**
+     * @brief Reads a field
+     * @param bits the width of the field, up to 64
+     * @return the value of the field
+     */
+    constexpr uint64_t read(size_t bits)
+    {
+      if (bits <= cacheMinBits)
+        return read_small(bits);
+      if constexpr (order == BitOrder::MSB_FIRST)
+      {
+        const uint64_t high = read_small(bits - 32);
+        return (high << 32) | read_small(32);
+      }
+      else
+      {
+        const uint64_t low = read_small(32);
+        return low | (read_small(bits - 32) << 32);
+      }
+    }
+
+    /**
+     * @brief Reads a single bit
+     */
+    constexpr bool read_bool()
+    {
+      return read_small(1) != 0;
+    }
+
+    /**
+     * @brief Reads a field without consuming it
+     * @param bits the width of the field, up to 56
+     * @return the value of the field
+     */
+    constexpr uint64_t peek(size_t bits)
+    {
+      refill();
+      if constexpr (order == BitOrder::MSB_FIRST)
+        return mCache >> 1 >> (63 - bits);
+      else
+        return mCache & detail::low_mask(bits);
+    }
+
+    /**
+     * @brief Skips bits
+     * @param bits the number of bits to skip
+     */
+    constexpr void skip(size_t bits)
+    {
+      if (bits <= mCount)
+      {
+        consume(bits);
+        return;
+      }
+      // Drop the accumulator and skip whole bytes of the buffer without reading them
+      bits -= mCount;
+      mCache = 0;
+      mCount = 0;
+      mPos += bits / 8;
+      read_small(bits % 8);
+    }
+
+    /**
+     * @brief Skips the bits up to the next byte boundary
+     */
+    constexpr void align()
+    {
+      skip((8 - bits_consumed() % 8) % 8);
+    }
+
+    /**
+     * @brief Reads an unary code: n zero bits followed by a one bit
+     * @return n
+     */
+    constexpr size_t read_unary()
+    {
+      size_t count = 0;
+      for (;;)
+      {
+        refill();
+        const size_t zeros = order == BitOrder::MSB_FIRST ? countl_zero(mCache) : countr_zero(mCache);
+        if (zeros < mCount)
+        {
+          consume(zeros + 1);
+          return count + zeros;
+        }
+        count += mCount;
+        consume(mCount);
+        if (overrun())
+          return count;
+      }
+    }
+
+    /**
+     * @brief Reads an unsigned Exp-Golomb code of order k
+     * @param k the order of the code (0 for the ue(v) codes of H.264)
+     * @return the decoded value, 0 with the overrun flag set if the code is longer than 64 bits
+     */
+    constexpr uint64_t read_exp_golomb(size_t k = 0)
+    {
+      const size_t zeros = read_unary();
+      if (zeros + k > 64 || zeros >= 64)
+      {
+        mInvalid = true;
+        return 0;
+      }
+      return (detail::low_mask(zeros) << k) + read(zeros + k);
+    }
+
+    /**
+     * @brief Reads a signed Exp-Golomb code of order 0 (se(v) of H.264: 0, 1, -1, 2, -2...)
+     * @return the decoded value
+     */
+    constexpr int64_t read_signed_exp_golomb()
+    {
+      const uint64_t code = read_exp_golomb();
+      return (code & 1) ? static_cast<int64_t>((code >> 1) + 1) : -static_cast<int64_t>(code >> 1);
+    }
+
+    /**
+     * @brief Reads a LEB128 variable length integer: groups of 7 bits, least significant first, stored in 8 bits
+     * fields whose most significant bit tells whether another group follows
+     * @return the decoded value, 0 with the overrun flag set if the code is longer than 10 groups
+     */
+    constexpr uint64_t read_varint()
+    {
+      uint64_t value = 0;
+      for (size_t shift = 0; shift < 64; shift += 7)
+      {
+        const uint64_t group = read_small(8);
+        value |= (group & 0x7F) << shift;
+        if ((group & 0x80) == 0)
+          return value;
+      }
+      mInvalid = true;
+      return 0;
+    }
+
+    /**
+     * @brief Reads a zigzag encoded LEB128 variable length integer (0, -1, 1, -2, 2...)
+     * @return the decoded value
+     */
+    constexpr int64_t read_signed_varint()
+    {
+      const uint64_t code = read_varint();
+      return static_cast<int64_t>(code >> 1) ^ -static_cast<int64_t>(code & 1);
+    }
+
+    /**
+     * @return the number of bits read or skipped so far
+     */
+    constexpr size_t bits_consumed() const
+    {
+      return mPos * 8 - mCount;
+    }
+
+    /**
+     * @return the number of bits that can still be read before reaching the end of the buffer
+     */
+    constexpr size_t bits_left() const
+    {
+      return overrun() ? 0 : mSize * 8 - bits_consumed();
+    }
+
+    /**
+     * @return true if bits were read past the end of the buffer or a malformed code was found
+     */
+    constexpr bool overrun() const
+    {
+      return mInvalid || bits_consumed() > mSize * 8;
+    }
+
+  private:
+    constexpr uint64_t read_small(size_t bits)
+    {
+      const uint64_t ret = peek(bits);
+      consume(bits);
+      return ret;
+    }
+
+    constexpr void consume(size_t bits)
+    {
+      if constexpr (order == BitOrder::MSB_FIRST)
+        mCache <<= bits;
+      else
+        mCache >>= bits;
+      mCount -= bits;
+    }
+
+    /**
+     * @brief Tops the accumulator up to at least cacheMinBits bits, past the end of the buffer 0 bits are fed
+     */
+    constexpr void refill()
+    {
+      if (mCount >= cacheMinBits)
+        return;
+      if (mPos + 8 <= mSize)
+      {
+        // Branchless refill: load 8 bytes, keep as many whole bytes as fit. The bits of the partially kept byte
+        // are loaded again, at the same place, by the next refill.
+        uint64_t word = 0;
+        for (size_t i = 0; i < 8; ++i)
+        {
+          if constexpr (order == BitOrder::MSB_FIRST)
+            word |= uint64_t{pData[mPos + i]} << (56 - 8 * i);
+          else
+            word |= uint64_t{pData[mPos + i]} << (8 * i);
+        }
+        if constexpr (order == BitOrder::MSB_FIRST)
+          mCache |= word >> mCount;
+        else
+          mCache |= word << mCount;
+        mPos += (63 - mCount) / 8;
+        mCount |= cacheMinBits;
+        return;
+      }
+      while (mCount < cacheMinBits)
+      {
+        const uint64_t byte = mPos < mSize ? pData[mPos] : 0;
+        if constexpr (order == BitOrder::MSB_FIRST)
+          mCache |= byte << (56 - mCount);
+        else
+          mCache |= byte << mCount;
+        ++mPos;
+        mCount += 8;
+      }
+    }
+
+    const uint8_t *pData;
+    size_t mSize;
+    size_t mPos = 0;        // Index of the next byte to be loaded in the accumulator
+    uint64_t mCache = 0;    // Next bits of the stream, the first one being the MSB (MSB_FIRST) or the LSB (LSB_FIRST)
+    size_t mCount = 0;      // Number of valid bits in mCache
+    bool mInvalid = false;
+  };
+
+  /**
+   * @brief Writes consecutive bit fields to a byte buffer.
+   * The fields are accumulated in a 64 bits register which is emitted byte by byte when it can not hold the next field.
+   * Writing past the end of the buffer drops the bits and sets the overflow flag.
+   * flush() must be called once all the fields have been written.
+   * @tparam order the order of the bits in the stream
+   */
+  template <BitOrder order = BitOrder::MSB_FIRST>
+  class BitWriter
+  {
+    // Largest field that is always accepted by the accumulator after a drain
+    static constexpr size_t cacheMaxBits = 56;
+
+  public:
+    /**
+     * @brief Constructor
+     * @param data the buffer to write to, must outlive the writer
+     * @param size the size of the buffer in bytes
+     */
+    constexpr BitWriter(uint8_t *data, size_t size) : pData(data), mSize(size) {}
+
+    /**
+     * @brief Writes a field
+     * @param value the value of the field, the bits above `bits` are ignored
+     * @param bits the width of the field, up to 64
+     */
+    constexpr void write(uint64_t value, size_t bits)
+    {
+      if (bits <= cacheMaxBits)
+      {
+        write_small(value, bits);
+        return;
+      }
+      if constexpr (order == BitOrder::MSB_FIRST)
+      {
+        write_small(value >> 32, bits - 32);
+        write_small(value, 32);
+      }
+      else
+      {
+        write_small(value, 32);
+        write_small(value >> 32, bits - 32);
+      }
+    }
+
+    /**
+     * @brief Writes a single bit
+     */
+    constexpr void write_bool(bool value)
+    {
+      write_small(value, 1);
+    }
+
+    /**
+     * @brief Writes an unary code: n zero bits followed by a one bit
+     */
+    constexpr void write_unary(size_t n)
+    {
+      for (; n > cacheMaxBits; n -= cacheMaxBits)
+      {
+        write_small(0, cacheMaxBits);
+      }
+      if constexpr (order == BitOrder::MSB_FIRST)
+        write_small(1, n + 1);
+      else
+        write_small(uint64_t{1} << n, n + 1);
+    }
+
+    /**
+     * @brief Writes an unsigned Exp-Golomb code of order k
+     * @param value the value to encode, lower than 2^64 - 2^k
+     * @param k the order of the code (0 for the ue(v) codes of H.264)
+     */
+    constexpr void write_exp_golomb(uint64_t value, size_t k = 0)
+    {
+      const size_t zeros = 63 - countl_zero((value >> k) + 1);
+      write_unary(zeros);
+      write(value - (detail::low_mask(zeros) << k), zeros + k);
+    }
+
+    /**
+     * @brief Writes a signed Exp-Golomb code of order 0 (se(v) of H.264: 0, 1, -1, 2, -2...)
+     */
+    constexpr void write_signed_exp_golomb(int64_t value)
+    {
+      write_exp_golomb(value > 0 ? 2 * static_cast<uint64_t>(value) - 1 : 2 * (0 - static_cast<uint64_t>(value)));
+    }
+
+    /**
+     * @brief Writes a LEB128 variable length integer (see BitReader::read_varint)
+     */
+    constexpr void write_varint(uint64_t value)
+    {
+      for (; value >= 0x80; value >>= 7)
+      {
+        write_small((value & 0x7F) | 0x80, 8);
+      }
+      write_small(value, 8);
+    }
+
+    /**
+     * @brief Writes a zigzag encoded LEB128 variable length integer (see BitReader::read_signed_varint)
+     */
+    constexpr void write_signed_varint(int64_t value)
+    {
+      write_varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    /**
+     * @brief Pads the stream with 0 bits up to the next byte boundary
+     */
+    constexpr void align()
+    {
+      write_small(0, (8 - mCount % 8) % 8);
+    }
+
+    /**
+     * @brief Aligns the stream and writes all the pending bits to the buffer
+     * @return the number of bytes of the buffer holding the stream
+     */
+    constexpr size_t flush()
+    {
+      align();
+      drain();
+      return bytes_written();
+    }
+
+    /**
+     * @return the number of bytes written to the buffer so far (pending bits excluded)
+     */
+    constexpr size_t bytes_written() const
+    {
+      return mPos < mSize ? mPos : mSize;
+    }
+
+    /**
+     * @return the number of bits written so far, including pending ones
+     */
+    constexpr size_t bits_written() const
+    {
+      return mPos * 8 + mCount;
+    }
+
+    /**
+     * @return true if bits were written past the end of the buffer (they were discarded)
+     */
+    constexpr bool overflow() const
+    {
+      return mPos > mSize;
+    }
+
+  private:
+    constexpr void write_small(uint64_t value, size_t bits)
+    {
+      if (mCount + bits > 64)
+        drain();
+      value &= detail::low_mask(bits);
+      if constexpr (order == BitOrder::MSB_FIRST)
+        mCache |= value << (64 - mCount - bits) % 64;
+      else
+        mCache |= value << mCount % 64;
+      mCount += bits;
+    }
+
+    /**
+     * @brief Writes the whole bytes of the accumulator to the buffer
+     */
+    constexpr void drain()
+    {
+      for (; mCount >= 8; mCount -= 8)
+      {
+        const uint8_t byte = static_cast<uint8_t>(order == BitOrder::MSB_FIRST ? mCache >> 56 : mCache);
+        if constexpr (order == BitOrder::MSB_FIRST)
+          mCache <<= 8;
+        else
+          mCache >>= 8;
+        if (mPos < mSize)
+          pData[mPos] = byte;
+        ++mPos;
+      }
+    }
+
+    uint8_t *pData;
+    size_t mSize;
+    size_t mPos = 0;     // Index of the next byte to be written to the buffer
+    uint64_t mCache = 0; // Pending bits, the first one being the MSB (MSB_FIRST) or the LSB (LSB_FIRST)
+    size_t mCount = 0;   // Number of pending bits in mCache
+  };
+} // namespace esutils
+
+#endif // ESUTILS_BIT_STREAM_HPP
@@ -269,6 +269,22 @@ namespace esutils
       return {mData[index / 8], static_cast<uint8_t>(7 - index % 8)};
     }
 
+    /**
+     * @return the number of bits in the collection
+     */
+    constexpr size_t size() const
+    {
+      return sz;
+    }
+
+    /**
+     * @return a pointer to the underlying bytes, bit i being stored in byte i / 8 at position 7 - i % 8
+     */
+    constexpr const uint8_t *data() const
+    {
+      return mData;
+    }
+
     /**
      * @brief Fills the bool collection with false
      */
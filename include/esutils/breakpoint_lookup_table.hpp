@@ -0,0 +1,168 @@
+#ifndef ESUTILS_BREAKPOINT_LOOKUP_TABLE_HPP
+#define ESUTILS_BREAKPOINT_LOOKUP_TABLE_HPP
+
+/**
+ * @file breakpoint_lookup_table.hpp
+ * Definition of the BreakpointLookUpTable class. This class stores a piecewise linear curve
+ * with freely placed breakpoints and evaluates it in a constant number of steps.
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "interpolation.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief A piecewise linear curve going through count (x, y) breakpoints whose x are strictly increasing
+   * but not evenly spaced, so that breakpoints can be concentrated where the curve bends.
+   * The segment containing an input is located by a branchless binary search that always does ceil(log2(count))
+   * comparisons (conditional moves, no data dependent branch), then the value is interpolated with the
+   * slope of the segment precomputed at construction. Inputs outside of [x0, xlast] are clamped.
+   * When T and X are both integral, the slopes are fixed point numbers and the interpolation is done in int64, so T is
+   * then limited to 32 bits.
+   * @tparam T the type of the values
+   * @tparam count the number of breakpoints
+   * @tparam X the type of the input
+   */
+  template <typename T, size_t count, typename X = T>
+  class BreakpointLookUpTable
+  {
+    static_assert(std::is_arithmetic_v<T> && std::is_arithmetic_v<X>, "T and X must be arithmetic types");
+    static_assert(!std::is_integral_v<X> || sizeof(X) <= 4, "Integral inputs are limited to 32 bits");
+    static_assert(count >= 2, "At least two breakpoints are needed");
+
+    static constexpr bool fixedPoint = std::is_integral_v<T> && std::is_integral_v<X>;
+    static_assert(!fixedPoint || sizeof(T) <= 4, "Integral values interpolated in fixed point are limited to 32 bits");
+
+    // Fractional bits of the fixed point slopes: (x - xi) * slope is bounded by (yi+1 - yi) * 2^slopeBits
+    // and must fit in an int64_t
+    static constexpr size_t slopeBits = fixedPoint ? detail::interpolation_fraction_bits<T>() : 0;
+
+    using slope_t = std::conditional_t<fixedPoint, int64_t, std::conditional_t<std::is_floating_point_v<T>, T, X>>;
+
+  public:
+    /**
+     * @brief Constructor
+     * @param breakpoints the x coordinates of the breakpoints, strictly increasing
+     * @param values the y coordinates of the breakpoints
+     */
+    constexpr BreakpointLookUpTable(const X (&breakpoints)[count], const T (&values)[count])
+    {
+      for (size_t i = 0; i < count; ++i)
+      {
+        mX[i] = breakpoints[i];
+        mY[i] = values[i];
+      }
+      compute_slopes();
+    }
+
+    /**
+     * @brief Constructor
+     * @param foo the function used to generate the values, called with each breakpoint
+     * @param breakpoints the x coordinates of the breakpoints, strictly increasing
+     */
+    template <typename Generator>
+    constexpr BreakpointLookUpTable(Generator foo, const X (&breakpoints)[count])
+    {
+      for (size_t i = 0; i < count; ++i)
+      {
+        mX[i] = breakpoints[i];
+        mY[i] = detail::to_value<T>(foo(breakpoints[i]));
+      }
+      compute_slopes();
+    }
+
+    /**
+     * @brief Evaluates the curve
+     * @param x the input, clamped to [x0, xlast]
+     * @return the interpolated value
+     */
+    constexpr T operator()(X x) const
+    {
+      x = x < mX[0] ? mX[0] : x;
+      x = x > mX[count - 1] ? mX[count - 1] : x;
+      const size_t i = segment(x);
+      if constexpr (fixedPoint)
+      {
+        const int64_t offset = (static_cast<int64_t>(x) - mX[i]) * mSlope[i];
+        return static_cast<T>(mY[i] + ((offset + (int64_t{1} << (slopeBits - 1))) >> slopeBits));
+      }
+      else
+      {
+        return detail::to_value<T>(mY[i] + (x - mX[i]) * mSlope[i]);
+      }
+    }
+
+    /**
+     * @param index the index of a breakpoint in the range [0, size()[
+     * @return the x coordinate of the breakpoint
+     */
+    constexpr X breakpoint(size_t index) const
+    {
+      return mX[index];
+    }
+
+    /**
+     * @brief Array index operator
+     * @param index the index of a breakpoint in the range [0, size()[
+     * @return the y coordinate of the breakpoint
+     */
+    constexpr T operator[](size_t index) const
+    {
+      return mY[index];
+    }
+
+    /**
+     * @return the number of breakpoints
+     */
+    constexpr size_t size() const
+    {
+      return count;
+    }
+
+  private:
+    /**
+     * @return the index of the last breakpoint lower than or equal to x, x being in [x0, xlast]
+     */
+    constexpr size_t segment(X x) const
+    {
+      size_t base = 0;
+      for (size_t n = count; n > 1; n -= n / 2)
+      {
+        base = mX[base + n / 2] <= x ? base + n / 2 : base;
+      }
+      return base;
+    }
+
+    constexpr void compute_slopes()
+    {
+      for (size_t i = 0; i + 1 < count; ++i)
+      {
+        if constexpr (fixedPoint)
+        {
+          const int64_t dx = static_cast<int64_t>(mX[i + 1]) - mX[i];
+          const int64_t dy = static_cast<int64_t>(mY[i + 1]) - mY[i];
+          // Division rounded to nearest
+          const int64_t scaled = dy * (int64_t{1} << slopeBits);
+          mSlope[i] = (scaled + (scaled < 0 ? -dx / 2 : dx / 2)) / dx;
+        }
+        else
+        {
+          mSlope[i] = static_cast<slope_t>(mY[i + 1] - mY[i]) / static_cast<slope_t>(mX[i + 1] - mX[i]);
+        }
+      }
+      // The last breakpoint starts a flat segment, so that xlast gives exactly ylast
+      mSlope[count - 1] = 0;
+    }
+
+    X mX[count]{};
+    T mY[count]{};
+    slope_t mSlope[count]{};
+  };
+} // namespace esutils
+
+#endif // ESUTILS_BREAKPOINT_LOOKUP_TABLE_HPP
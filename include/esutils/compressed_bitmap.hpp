@@ -0,0 +1,911 @@
+#ifndef ESUTILS_COMPRESSED_BITMAP_HPP
+#define ESUTILS_COMPRESSED_BITMAP_HPP
+
+/**
+ * @file compressed_bitmap.hpp
+ * Definition of a compressed bitmap over the whole uint32_t domain (roaring bitmap layout)
+ * @note Unlike the other containers of this library, this one allocates on the heap: it is meant for
+ * host side processing where the memory footprint has to follow the cardinality
+ * @author Etienne Santoul
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "bit_operations.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief A set of uint32_t stored as a sorted list of 64K chunks.
+   * Each chunk keeps the low 16 bits of its values in the most compact of three containers:
+   *  - a sorted array of uint16_t (sparse chunks, up to 4096 values)
+   *  - a 65536 bits bitmap (dense chunks)
+   *  - a sorted list of runs (chunks made of long consecutive ranges)
+   * Union and intersection are performed chunk by chunk with a dedicated algorithm for every container pair.
+   */
+  class CompressedBitmap
+  {
+    static constexpr size_t arrayMaxCardinality = 4096;
+    static constexpr size_t bitmapWords = 1024;
+    static constexpr uint32_t noValue = 0x10000; // Returned by container next() when there is no value left
+
+    /**
+     * @brief Sorted array of values, for sparse chunks
+     */
+    struct ArrayContainer
+    {
+      std::vector<uint16_t> values;
+
+      size_t cardinality() const { return values.size(); }
+
+      bool contains(uint16_t v) const
+      {
+        return std::binary_search(values.begin(), values.end(), v);
+      }
+
+      bool add(uint16_t v)
+      {
+        const auto it = std::lower_bound(values.begin(), values.end(), v);
+        if (it != values.end() && *it == v)
+          return false;
+        values.insert(it, v);
+        return true;
+      }
+
+      bool remove(uint16_t v)
+      {
+        const auto it = std::lower_bound(values.begin(), values.end(), v);
+        if (it == values.end() || *it != v)
+          return false;
+        values.erase(it);
+        return true;
+      }
+
+      uint32_t next(uint32_t from) const
+      {
+        const auto it = std::lower_bound(values.begin(), values.end(), from);
+        return it == values.end() ? noValue : *it;
+      }
+
+      template <typename Func>
+      void for_each(Func &&foo) const
+      {
+        for (const uint16_t v : values)
+          foo(v);
+      }
+
+      size_t memory_usage() const { return values.capacity() * sizeof(uint16_t); }
+    };
+
+    /**
+     * @brief Plain bitmap of the whole chunk, for dense chunks
+     */
+    struct BitmapContainer
+    {
+      std::vector<uint64_t> words = std::vector<uint64_t>(bitmapWords, 0);
+      size_t card = 0;
+
+      size_t cardinality() const { return card; }
+
+      bool contains(uint16_t v) const
+      {
+        return (words[v >> 6] >> (v & 63)) & 1;
+      }
+
+      bool add(uint16_t v)
+      {
+        const uint64_t mask = uint64_t{1} << (v & 63);
+        uint64_t &word = words[v >> 6];
+        if (word & mask)
+          return false;
+        word |= mask;
+        ++card;
+        return true;
+      }
+
+      bool remove(uint16_t v)
+      {
+        const uint64_t mask = uint64_t{1} << (v & 63);
+        uint64_t &word = words[v >> 6];
+        if ((word & mask) == 0)
+          return false;
+        word &= ~mask;
+        --card;
+        return true;
+      }
+
+      /**
+       * @brief Sets all the bits in [first, last], the cardinality must be recomputed afterwards
+       */
+      void set_range(uint32_t first, uint32_t last)
+      {
+        const uint32_t firstWord = first >> 6;
+        const uint32_t lastWord = last >> 6;
+        const uint64_t firstMask = ~uint64_t{0} << (first & 63);
+        const uint64_t lastMask = ~uint64_t{0} >> (63 - (last & 63));
+        if (firstWord == lastWord)
+        {
+          words[firstWord] |= firstMask & lastMask;
+          return;
+        }
+        words[firstWord] |= firstMask;
+        for (uint32_t w = firstWord + 1; w < lastWord; ++w)
+          words[w] = ~uint64_t{0};
+        words[lastWord] |= lastMask;
+      }
+
+      void recount()
+      {
+        card = 0;
+        for (const uint64_t word : words)
+          card += popcount(word);
+      }
+
+      size_t count_runs() const
+      {
+        size_t runs = 0;
+        uint64_t carry = 0; // Highest bit of the previous word
+        for (const uint64_t word : words)
+        {
+          // A run starts on every set bit whose lower neighbour is clear
+          runs += popcount(word & ~((word << 1) | carry));
+          carry = word >> 63;
+        }
+        return runs;
+      }
+
+      uint32_t next(uint32_t from) const
+      {
+        if (from >= noValue)
+          return noValue;
+        uint32_t w = from >> 6;
+        uint64_t word = words[w] & (~uint64_t{0} << (from & 63));
+        while (word == 0)
+        {
+          if (++w == bitmapWords)
+            return noValue;
+          word = words[w];
+        }
+        return (w << 6) + countr_zero(word);
+      }
+
+      template <typename Func>
+      void for_each(Func &&foo) const
+      {
+        for (uint32_t w = 0; w < bitmapWords; ++w)
+        {
+          uint64_t word = words[w];
+          while (word)
+          {
+            foo(static_cast<uint16_t>((w << 6) + countr_zero(word)));
+            word &= word - 1;
+          }
+        }
+      }
+
+      size_t memory_usage() const { return words.capacity() * sizeof(uint64_t); }
+    };
+
+    /**
+     * @brief A range of consecutive values [start, start + length]
+     */
+    struct Run
+    {
+      uint16_t start;
+      uint16_t length;
+
+      uint32_t last() const { return uint32_t{start} + length; }
+    };
+
+    /**
+     * @brief Sorted list of disjoint, non adjacent runs, for chunks made of long ranges
+     */
+    struct RunContainer
+    {
+      std::vector<Run> runs;
+
+      size_t cardinality() const
+      {
+        size_t card = 0;
+        for (const Run &r : runs)
+          card += r.length + size_t{1};
+        return card;
+      }
+
+      /**
+       * @return the index of the last run starting at or before v, or runs.size() if there is none
+       */
+      size_t find_run(uint32_t v) const
+      {
+        const auto it = std::upper_bound(runs.begin(), runs.end(), v, [](uint32_t val, const Run &r) { return val < r.start; });
+        return it == runs.begin() ? runs.size() : static_cast<size_t>(std::distance(runs.begin(), it)) - 1;
+      }
+
+      bool contains(uint16_t v) const
+      {
+        const size_t i = find_run(v);
+        return i != runs.size() && v <= runs[i].last();
+      }
+
+      bool add(uint16_t v)
+      {
+        const size_t i = find_run(v);
+        if (i != runs.size() && v <= runs[i].last())
+          return false;
+
+        const size_t nextRun = i == runs.size() ? 0 : i + 1;
+        const bool extendsPrevious = i != runs.size() && runs[i].last() + 1 == v;
+        const bool extendsNext = nextRun < runs.size() && v + uint32_t{1} == runs[nextRun].start;
+
+        if (extendsPrevious && extendsNext) // v fills the gap between two runs
+        {
+          runs[i].length = static_cast<uint16_t>(runs[nextRun].last() - runs[i].start);
+          runs.erase(runs.begin() + nextRun);
+        }
+        else if (extendsPrevious)
+        {
+          ++runs[i].length;
+        }
+        else if (extendsNext)
+        {
+          --runs[nextRun].start;
+          ++runs[nextRun].length;
+        }
+        else
+        {
+          runs.insert(runs.begin() + nextRun, Run{v, 0});
+        }
+        return true;
+      }
+
+      bool remove(uint16_t v)
+      {
+        const size_t i = find_run(v);
+        if (i == runs.size() || v > runs[i].last())
+          return false;
+
+        Run &r = runs[i];
+        if (r.length == 0)
+        {
+          runs.erase(runs.begin() + i);
+        }
+        else if (v == r.start)
+        {
+          ++r.start;
+          --r.length;
+        }
+        else if (v == r.last())
+        {
+          --r.length;
+        }
+        else // Split the run in two
+        {
+          const Run upper{static_cast<uint16_t>(v + 1), static_cast<uint16_t>(r.last() - v - 1)};
+          r.length = static_cast<uint16_t>(v - r.start - 1);
+          runs.insert(runs.begin() + i + 1, upper);
+        }
+        return true;
+      }
+
+      /**
+       * @brief Appends the range [first, last], merging it with the last run if they touch or overlap.
+       * Ranges must be appended in increasing order of their first value.
+       */
+      void append(uint32_t first, uint32_t last)
+      {
+        if (!runs.empty() && first <= runs.back().last() + 1)
+        {
+          if (last > runs.back().last())
+            runs.back().length = static_cast<uint16_t>(last - runs.back().start);
+          return;
+        }
+        runs.push_back(Run{static_cast<uint16_t>(first), static_cast<uint16_t>(last - first)});
+      }
+
+      uint32_t next(uint32_t from) const
+      {
+        if (from >= noValue)
+          return noValue;
+        size_t i = find_run(from);
+        if (i != runs.size() && from <= runs[i].last())
+          return from;
+        i = i == runs.size() ? 0 : i + 1;
+        return i < runs.size() ? runs[i].start : noValue;
+      }
+
+      template <typename Func>
+      void for_each(Func &&foo) const
+      {
+        for (const Run &r : runs)
+        {
+          for (uint32_t v = r.start; v <= r.last(); ++v)
+            foo(static_cast<uint16_t>(v));
+        }
+      }
+
+      size_t memory_usage() const { return runs.capacity() * sizeof(Run); }
+    };
+
+    using Container = std::variant<ArrayContainer, BitmapContainer, RunContainer>;
+
+    struct Chunk
+    {
+      uint16_t key;
+      Container container;
+    };
+
+  public:
+    /**
+     * @brief Constant forward iterator object, returns the values in increasing order
+     */
+    class ConstIterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = uint32_t;
+      using difference_type = ptrdiff_t;
+      using pointer = const uint32_t *;
+      using reference = uint32_t;
+
+      ConstIterator(const CompressedBitmap *parent, size_t chunk)
+        :
+        mParent(parent),
+        mChunk(chunk),
+        mValue(0)
+      {
+        seek(0);
+      }
+
+      uint32_t operator*() const
+      {
+        return mValue;
+      }
+
+      bool operator==(const ConstIterator &other) const
+      {
+        return mParent == other.mParent && mChunk == other.mChunk && (mChunk == mParent->mChunks.size() || mValue == other.mValue);
+      }
+
+      bool operator!=(const ConstIterator &other) const
+      {
+        return !(*this == other);
+      }
+
+      ConstIterator &operator++()
+      {
+        seek((mValue & 0xFFFF) + 1);
+        return *this;
+      }
+
+    private:
+      /**
+       * @brief Moves to the first value of the current chunk whose low bits are >= low, or to the following chunks
+       */
+      void seek(uint32_t low)
+      {
+        for (; mChunk < mParent->mChunks.size(); ++mChunk, low = 0)
+        {
+          const Chunk &c = mParent->mChunks[mChunk];
+          const uint32_t found = std::visit([low](const auto &container) { return container.next(low); }, c.container);
+          if (found != noValue)
+          {
+            mValue = (uint32_t{c.key} << 16) | found;
+            return;
+          }
+        }
+      }
+
+      const CompressedBitmap *mParent;
+      size_t mChunk;
+      uint32_t mValue;
+    };
+
+    CompressedBitmap() = default;
+
+    /**
+     * @brief Adds a value
+     * @return true if the value was added, false if it was already present
+     */
+    bool add(uint32_t v)
+    {
+      Chunk &c = get_or_create_chunk(high_bits(v));
+      const bool added = std::visit([v](auto &container) { return container.add(low_bits(v)); }, c.container);
+      if (added)
+        shrink(c.container);
+      return added;
+    }
+
+    /**
+     * @brief Adds all the values in [first, last]
+     */
+    void add_range(uint32_t first, uint32_t last)
+    {
+      if (first > last)
+        return;
+      for (uint32_t key = high_bits(first);; ++key)
+      {
+        const uint32_t low = key == high_bits(first) ? low_bits(first) : 0;
+        const uint32_t high = key == high_bits(last) ? low_bits(last) : 0xFFFF;
+        RunContainer range;
+        range.append(low, high);
+
+        Chunk &c = get_or_create_chunk(static_cast<uint16_t>(key));
+        c.container = container_union(c.container, Container{std::move(range)});
+        if (key == high_bits(last))
+          break;
+      }
+    }
+
+    /**
+     * @brief Removes a value
+     * @return true if the value was removed, false if it was not present
+     */
+    bool remove(uint32_t v)
+    {
+      const auto it = find_chunk(high_bits(v));
+      if (it == mChunks.end() || it->key != high_bits(v))
+        return false;
+      const bool removed = std::visit([v](auto &container) { return container.remove(low_bits(v)); }, it->container);
+      if (removed)
+      {
+        if (container_cardinality(it->container) == 0)
+          mChunks.erase(it);
+        else
+          shrink(it->container);
+      }
+      return removed;
+    }
+
+    /**
+     * @return true if the value is in the bitmap
+     */
+    bool contains(uint32_t v) const
+    {
+      const auto it = find_chunk(high_bits(v));
+      if (it == mChunks.end() || it->key != high_bits(v))
+        return false;
+      return std::visit([v](const auto &container) { return container.contains(low_bits(v)); }, it->container);
+    }
+
+    /**
+     * @return the number of values in the bitmap
+     */
+    size_t cardinality() const
+    {
+      size_t card = 0;
+      for (const Chunk &c : mChunks)
+        card += container_cardinality(c.container);
+      return card;
+    }
+
+    /**
+     * @return true if the bitmap contains no value
+     */
+    bool empty() const
+    {
+      return mChunks.empty();
+    }
+
+    /**
+     * @brief Removes all the values
+     */
+    void clear()
+    {
+      mChunks.clear();
+    }
+
+    /**
+     * @brief Converts every chunk to its most compact container, including run containers
+     */
+    void run_optimize()
+    {
+      for (Chunk &c : mChunks)
+        c.container = optimize(std::move(c.container));
+    }
+
+    /**
+     * @return the number of bytes used by the stored values (excluding the bitmap object itself)
+     */
+    size_t memory_usage() const
+    {
+      size_t bytes = mChunks.capacity() * sizeof(Chunk);
+      for (const Chunk &c : mChunks)
+        bytes += std::visit([](const auto &container) { return container.memory_usage(); }, c.container);
+      return bytes;
+    }
+
+    /**
+     * @brief Calls foo(uint32_t value) for every value in increasing order
+     */
+    template <typename Func>
+    void for_each(Func &&foo) const
+    {
+      for (const Chunk &c : mChunks)
+      {
+        const uint32_t high = uint32_t{c.key} << 16;
+        std::visit([&foo, high](const auto &container) { container.for_each([&foo, high](uint16_t low) { foo(high | low); }); }, c.container);
+      }
+    }
+
+    ConstIterator begin() const
+    {
+      return {this, 0};
+    }
+
+    ConstIterator end() const
+    {
+      return {this, mChunks.size()};
+    }
+
+    /**
+     * @brief In place union
+     */
+    CompressedBitmap &operator|=(const CompressedBitmap &other)
+    {
+      std::vector<Chunk> result;
+      result.reserve(mChunks.size() + other.mChunks.size());
+      auto a = mChunks.begin();
+      auto b = other.mChunks.begin();
+      while (a != mChunks.end() || b != other.mChunks.end())
+      {
+        if (b == other.mChunks.end() || (a != mChunks.end() && a->key < b->key))
+          result.push_back(std::move(*a++));
+        else if (a == mChunks.end() || b->key < a->key)
+          result.push_back(*b++);
+        else
+        {
+          result.push_back({a->key, container_union(a->container, b->container)});
+          ++a;
+          ++b;
+        }
+      }
+      mChunks = std::move(result);
+      return *this;
+    }
+
+    /**
+     * @brief In place intersection
+     */
+    CompressedBitmap &operator&=(const CompressedBitmap &other)
+    {
+      std::vector<Chunk> result;
+      auto a = mChunks.begin();
+      auto b = other.mChunks.begin();
+      while (a != mChunks.end() && b != other.mChunks.end())
+      {
+        if (a->key < b->key)
+          ++a;
+        else if (b->key < a->key)
+          ++b;
+        else
+        {
+          Container c = container_intersection(a->container, b->container);
+          if (container_cardinality(c) != 0)
+            result.push_back({a->key, std::move(c)});
+          ++a;
+          ++b;
+        }
+      }
+      mChunks = std::move(result);
+      return *this;
+    }
+
+    friend CompressedBitmap operator|(CompressedBitmap lhs, const CompressedBitmap &rhs)
+    {
+      return lhs |= rhs;
+    }
+
+    friend CompressedBitmap operator&(CompressedBitmap lhs, const CompressedBitmap &rhs)
+    {
+      return lhs &= rhs;
+    }
+
+    bool operator==(const CompressedBitmap &other) const
+    {
+      return cardinality() == other.cardinality() && std::equal(begin(), end(), other.begin());
+    }
+
+    bool operator!=(const CompressedBitmap &other) const
+    {
+      return !(*this == other);
+    }
+
+  private:
+    static uint16_t high_bits(uint32_t v) { return static_cast<uint16_t>(v >> 16); }
+    static uint16_t low_bits(uint32_t v) { return static_cast<uint16_t>(v & 0xFFFF); }
+
+    std::vector<Chunk>::iterator find_chunk(uint16_t key)
+    {
+      return std::lower_bound(mChunks.begin(), mChunks.end(), key, [](const Chunk &c, uint16_t k) { return c.key < k; });
+    }
+
+    std::vector<Chunk>::const_iterator find_chunk(uint16_t key) const
+    {
+      return std::lower_bound(mChunks.begin(), mChunks.end(), key, [](const Chunk &c, uint16_t k) { return c.key < k; });
+    }
+
+    Chunk &get_or_create_chunk(uint16_t key)
+    {
+      auto it = find_chunk(key);
+      if (it == mChunks.end() || it->key != key)
+        it = mChunks.insert(it, Chunk{key, ArrayContainer{}});
+      return *it;
+    }
+
+    static size_t container_cardinality(const Container &c)
+    {
+      return std::visit([](const auto &container) { return container.cardinality(); }, c);
+    }
+
+    template <typename Source>
+    static BitmapContainer to_bitmap(const Source &src)
+    {
+      BitmapContainer bitmap;
+      if constexpr (std::is_same_v<Source, RunContainer>)
+      {
+        for (const Run &r : src.runs)
+          bitmap.set_range(r.start, r.last());
+        bitmap.recount();
+      }
+      else
+      {
+        src.for_each([&bitmap](uint16_t v) { bitmap.add(v); });
+      }
+      return bitmap;
+    }
+
+    template <typename Source>
+    static ArrayContainer to_array(const Source &src)
+    {
+      ArrayContainer array;
+      array.values.reserve(src.cardinality());
+      src.for_each([&array](uint16_t v) { array.values.push_back(v); });
+      return array;
+    }
+
+    template <typename Source>
+    static RunContainer to_runs(const Source &src)
+    {
+      RunContainer runs;
+      src.for_each([&runs](uint16_t v) { runs.append(v, v); });
+      return runs;
+    }
+
+    /**
+     * @brief Cheap conversions performed after every modification: keeps arrays and bitmaps on the right
+     * side of the 4096 values threshold and gets rid of run containers that became bigger than the alternatives
+     */
+    static void shrink(Container &c)
+    {
+      if (auto *array = std::get_if<ArrayContainer>(&c))
+      {
+        if (array->cardinality() > arrayMaxCardinality)
+          c = to_bitmap(*array);
+      }
+      else if (auto *bitmap = std::get_if<BitmapContainer>(&c))
+      {
+        if (bitmap->cardinality() <= arrayMaxCardinality)
+          c = to_array(*bitmap);
+      }
+      else
+      {
+        const auto &runs = std::get<RunContainer>(c);
+        const size_t card = runs.cardinality();
+        const size_t runBytes = runs.runs.size() * sizeof(Run);
+        if (card <= arrayMaxCardinality && card * sizeof(uint16_t) < runBytes)
+          c = to_array(runs);
+        else if (bitmapWords * sizeof(uint64_t) < runBytes)
+          c = to_bitmap(runs);
+      }
+    }
+
+    /**
+     * @brief Full conversion to the smallest container, which requires counting runs
+     */
+    static Container optimize(Container c)
+    {
+      const size_t card = container_cardinality(c);
+      const size_t runCount = std::visit([](const auto &container) -> size_t {
+        if constexpr (std::is_same_v<std::decay_t<decltype(container)>, BitmapContainer>)
+          return container.count_runs();
+        else if constexpr (std::is_same_v<std::decay_t<decltype(container)>, RunContainer>)
+          return container.runs.size();
+        else
+        {
+          size_t count = 0;
+          uint32_t previous = noValue;
+          container.for_each([&count, &previous](uint16_t v) {
+            count += (previous == noValue || v != previous + 1);
+            previous = v;
+          });
+          return count;
+        }
+      }, c);
+
+      const size_t runBytes = runCount * sizeof(Run);
+      const size_t arrayBytes = card <= arrayMaxCardinality ? card * sizeof(uint16_t) : SIZE_MAX;
+      const size_t bitmapBytes = bitmapWords * sizeof(uint64_t);
+
+      return std::visit([&](const auto &container) -> Container {
+        if (runBytes < arrayBytes && runBytes < bitmapBytes)
+          return to_runs(container);
+        if (arrayBytes <= bitmapBytes)
+          return to_array(container);
+        return to_bitmap(container);
+      }, c);
+    }
+
+    static RunContainer merge_runs_and_array(const RunContainer &runs, const ArrayContainer &array)
+    {
+      RunContainer merged;
+      auto ir = runs.runs.begin();
+      auto iv = array.values.begin();
+      while (ir != runs.runs.end() || iv != array.values.end())
+      {
+        if (iv == array.values.end() || (ir != runs.runs.end() && ir->start < *iv))
+        {
+          merged.append(ir->start, ir->last());
+          ++ir;
+        }
+        else
+        {
+          merged.append(*iv, *iv);
+          ++iv;
+        }
+      }
+      return merged;
+    }
+
+    template <typename Other>
+    static BitmapContainer intersect_bitmap(const BitmapContainer &bitmap, const Other &other)
+    {
+      BitmapContainer common = bitmap;
+      if constexpr (std::is_same_v<Other, BitmapContainer>)
+      {
+        for (size_t w = 0; w < bitmapWords; ++w)
+          common.words[w] &= other.words[w];
+      }
+      else
+      {
+        const BitmapContainer mask = to_bitmap(other);
+        for (size_t w = 0; w < bitmapWords; ++w)
+          common.words[w] &= mask.words[w];
+      }
+      common.recount();
+      return common;
+    }
+
+    static Container container_union(const Container &lhs, const Container &rhs)
+    {
+      Container result = std::visit([](const auto &a, const auto &b) -> Container {
+        using A = std::decay_t<decltype(a)>;
+        using B = std::decay_t<decltype(b)>;
+        if constexpr (std::is_same_v<A, ArrayContainer> && std::is_same_v<B, ArrayContainer>)
+        {
+          ArrayContainer merged;
+          merged.values.reserve(a.values.size() + b.values.size());
+          std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), std::back_inserter(merged.values));
+          return merged;
+        }
+        else if constexpr (std::is_same_v<A, RunContainer> && std::is_same_v<B, RunContainer>)
+        {
+          RunContainer merged;
+          auto ia = a.runs.begin();
+          auto ib = b.runs.begin();
+          while (ia != a.runs.end() || ib != b.runs.end())
+          {
+            const Run &r = (ib == b.runs.end() || (ia != a.runs.end() && ia->start < ib->start)) ? *ia++ : *ib++;
+            merged.append(r.start, r.last());
+          }
+          return merged;
+        }
+        else if constexpr (std::is_same_v<A, BitmapContainer> && std::is_same_v<B, BitmapContainer>)
+        {
+          BitmapContainer merged = a;
+          for (size_t w = 0; w < bitmapWords; ++w)
+            merged.words[w] |= b.words[w];
+          merged.recount();
+          return merged;
+        }
+        else if constexpr (std::is_same_v<A, BitmapContainer>)
+        {
+          BitmapContainer merged = a;
+          b.for_each([&merged](uint16_t v) { merged.add(v); });
+          return merged;
+        }
+        else if constexpr (std::is_same_v<B, BitmapContainer>)
+        {
+          BitmapContainer merged = b;
+          a.for_each([&merged](uint16_t v) { merged.add(v); });
+          return merged;
+        }
+        else if constexpr (std::is_same_v<A, RunContainer>)
+        {
+          return merge_runs_and_array(a, b);
+        }
+        else
+        {
+          return merge_runs_and_array(b, a);
+        }
+      }, lhs, rhs);
+
+      if (std::holds_alternative<ArrayContainer>(result))
+        shrink(result);
+      else
+        result = optimize(std::move(result));
+      return result;
+    }
+
+    static Container container_intersection(const Container &lhs, const Container &rhs)
+    {
+      Container result = std::visit([](const auto &a, const auto &b) -> Container {
+        using A = std::decay_t<decltype(a)>;
+        using B = std::decay_t<decltype(b)>;
+        if constexpr (std::is_same_v<A, ArrayContainer> && std::is_same_v<B, ArrayContainer>)
+        {
+          ArrayContainer common;
+          std::set_intersection(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), std::back_inserter(common.values));
+          return common;
+        }
+        else if constexpr (std::is_same_v<A, ArrayContainer> || std::is_same_v<B, ArrayContainer>)
+        {
+          // Filter the array with the other container
+          ArrayContainer common;
+          auto filter = [&common](const ArrayContainer &values, const auto &other) {
+            for (const uint16_t v : values.values)
+              if (other.contains(v))
+                common.values.push_back(v);
+          };
+          if constexpr (std::is_same_v<A, ArrayContainer>)
+            filter(a, b);
+          else
+            filter(b, a);
+          return common;
+        }
+        else if constexpr (std::is_same_v<A, RunContainer> && std::is_same_v<B, RunContainer>)
+        {
+          RunContainer common;
+          auto ia = a.runs.begin();
+          auto ib = b.runs.begin();
+          while (ia != a.runs.end() && ib != b.runs.end())
+          {
+            const uint32_t first = std::max<uint32_t>(ia->start, ib->start);
+            const uint32_t last = std::min(ia->last(), ib->last());
+            if (first <= last)
+              common.append(first, last);
+            if (ia->last() < ib->last())
+              ++ia;
+            else
+              ++ib;
+          }
+          return common;
+        }
+        else if constexpr (std::is_same_v<A, BitmapContainer>)
+        {
+          return intersect_bitmap(a, b);
+        }
+        else
+        {
+          return intersect_bitmap(b, a);
+        }
+      }, lhs, rhs);
+
+      if (std::holds_alternative<ArrayContainer>(result))
+        shrink(result);
+      else
+        result = optimize(std::move(result));
+      return result;
+    }
+
+    std::vector<Chunk> mChunks;
+  };
+} // namespace esutils
+
+#endif // ESUTILS_COMPRESSED_BITMAP_HPP
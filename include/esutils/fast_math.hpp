@@ -0,0 +1,598 @@
+#ifndef ESUTILS_FAST_MATH_HPP
+#define ESUTILS_FAST_MATH_HPP
+
+/**
+ * @file fast_math.hpp
+ * Fast approximations of elementary functions with selectable accuracy, in floating point and in fixed point.
+ * The polynomials are minimax fits (Remez exchange) and the maximum errors given for each function
+ * are the ones measured by test_fast_math.cpp, which enforces them.
+ * The floating point functions have no data dependent branch, so that their batch overloads, which apply them to arrays,
+ * are vectorized by the compiler. The fixed point functions are meant for cores without floating point unit.
+ * @author Etienne Santoul
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "bit_operations.hpp"
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_bit_cast)
+#define ESUTILS_HAS_BUILTIN_BIT_CAST
+#endif
+#endif
+
+// The functions reading the representation of floating point numbers are only constexpr with __builtin_bit_cast
+#if defined(ESUTILS_HAS_BUILTIN_BIT_CAST)
+#define ESUTILS_BIT_CAST_CONSTEXPR constexpr
+#else
+#define ESUTILS_BIT_CAST_CONSTEXPR inline
+#endif
+
+namespace esutils
+{
+  /**
+   * @brief Accuracy tier of an approximation: higher tiers evaluate longer polynomials or iterate more
+   */
+  enum class Accuracy
+  {
+    LOW,
+    MEDIUM,
+    HIGH
+  };
+
+  namespace detail
+  {
+    constexpr double pi = 3.14159265358979323846;
+
+    template <typename To, typename From>
+    ESUTILS_BIT_CAST_CONSTEXPR To bit_cast(const From &from)
+    {
+      static_assert(sizeof(To) == sizeof(From), "The types must have the same size");
+#if defined(ESUTILS_HAS_BUILTIN_BIT_CAST)
+      return __builtin_bit_cast(To, from);
+#else
+      To to{};
+      std::memcpy(&to, &from, sizeof(To));
+      return to;
+#endif
+    }
+
+    template <typename T>
+    struct FloatTraits;
+
+    template <>
+    struct FloatTraits<float>
+    {
+      using uint_t = uint32_t;
+      using int_t = int32_t;
+      static constexpr int mantissaBits = 23;
+      static constexpr int bias = 127;
+      static constexpr uint_t invSqrtMagic = 0x5F375A86;
+      static constexpr uint_t sqrt2Mantissa = 0x3504F3; // Mantissa bits of sqrt(2)
+      // pi split in parts whose products by the multiples of pi met in the reduction are exact
+      static constexpr float piHi = 3.140625f;
+      static constexpr float piMid = 9.67502593994140625e-4f;
+      static constexpr float piLo = 1.509957990978376432e-7f;
+    };
+
+    template <>
+    struct FloatTraits<double>
+    {
+      using uint_t = uint64_t;
+      using int_t = int64_t;
+      static constexpr int mantissaBits = 52;
+      static constexpr int bias = 1023;
+      static constexpr uint_t invSqrtMagic = 0x5FE6EB50C7B537A9;
+      static constexpr uint_t sqrt2Mantissa = 0x6A09E667F3BCD;
+      static constexpr double piHi = 3.1415926218032837;
+      static constexpr double piMid = 3.178650954705639e-08;
+      static constexpr double piLo = 1.273663432697993e-24;
+    };
+
+    /**
+     * @brief Minimax coefficients of each tier, lowest degree first:
+     *  - sin(x) = x * P(x^2) on [-pi/2, pi/2], absolute error, degree 5 / 7 / 11
+     *  - 2^x = P(x) on [0, 1], relative error, degree 3 / 5 / 7
+     *  - log2(1 + u) = u * P(u) on [sqrt(1/2) - 1, sqrt(2) - 1], absolute error, degree 4 / 7 / 9
+     *  - atan(x) = x * P(x^2) on [0, 1], absolute error, degree 7 / 11 / 17
+     */
+    template <Accuracy accuracy>
+    struct FastMathTier;
+
+    template <>
+    struct FastMathTier<Accuracy::LOW>
+    {
+      static constexpr double sin[] = {0.9999008951796994, -0.16591104183850353, 0.00757021159998956};
+      static constexpr double exp2[] = {0.99992521856401, 0.695833540506448, 0.22606715539313021, 0.07802452266443176};
+      static constexpr double log2[] = {1.4404475424631267, -0.7209735119740608, 0.53962514992916, -0.38994671337040643};
+      static constexpr double atan[] = {0.9998745501842491, -0.32658607450314847, 0.1560634330937258,
+                                        -0.04395374550282804};
+      static constexpr int newtonSteps = 1;
+      static constexpr int cordicIterations = 8;
+    };
+
+    template <>
+    struct FastMathTier<Accuracy::MEDIUM>
+    {
+      static constexpr double sin[] = {0.9999996185229959, -0.16665846900971718, 0.008313958670440769,
+                                       -0.0001852321989947647};
+      static constexpr double exp2[] = {0.9999999250635297,   0.6931530732000758,  0.24015361704533342,
+                                        0.055826318050039916, 0.00898934009471393, 0.0018775766733667028};
+      static constexpr double log2[] = {1.4427044471993173,  -0.721351052714422,  0.48018141068166975,
+                                        -0.35986963731315735, 0.30207440397244517, -0.2655921408041349,
+                                        0.14452061816515813};
+      static constexpr double atan[] = {0.9999995669066353,  -0.33322609323641283, 0.1975368867937104,
+                                        -0.1264000176954476, 0.06305942086531796,  -0.015571600236787959};
+      static constexpr int newtonSteps = 2;
+      static constexpr int cordicIterations = 12;
+    };
+
+    template <>
+    struct FastMathTier<Accuracy::HIGH>
+    {
+      static constexpr double sin[] = {0.9999999999987953,     -0.16666666654618467,  0.00833333224859102,
+                                       -0.0001984100291214904, 2.753152957425696e-06, -2.398473804711813e-08};
+      static constexpr double exp2[] = {0.999999999959789,     0.693147186083901,     0.24022638461779902,
+                                        0.05550512686067691,   0.00961401700892646,   0.0013422634864433472,
+                                        0.0001435231375867777, 2.1498764455520045e-05};
+      static constexpr double log2[] = {1.4426948284836008,  -0.7213474534161134, 0.4809262960356344,
+                                        -0.36070013359903697, 0.28754592509039645, -0.2389036830235485,
+                                        0.21874250263055922,  -0.208190715470041,  0.11922683253812286};
+      static constexpr double atan[] = {0.9999999999305497,   -0.33333324974091005, 0.1999918897564059,
+                                        -0.14265915304211577, 0.10918861425676912,  -0.08156168392997754,
+                                        0.050955390786659185, -0.02142426292220133, 0.004240618302269221};
+      static constexpr int newtonSteps = 3;
+      static constexpr int cordicIterations = 16;
+    };
+
+    /**
+     * @brief Angles atan(2^-i) of the CORDIC rotations, pi being 2^30
+     */
+    constexpr int64_t cordicAngles[] = {268435456, 158466703, 83729454, 42502378, 21333666, 10677233,
+                                        5339919,   2670123,   1335082,  667543,   333772,   166886,
+                                        83443,     41722,     20861,    10430};
+
+    template <typename T, size_t n>
+    constexpr T horner(T x, const double (&c)[n])
+    {
+      T p = static_cast<T>(c[n - 1]);
+      for (size_t i = n - 1; i-- > 0;)
+      {
+        p = p * x + static_cast<T>(c[i]);
+      }
+      return p;
+    }
+
+    /**
+     * @brief Converts polynomial coefficients to Q30, the coefficient of degree i being multiplied by first * scale^i
+     */
+    template <size_t n>
+    constexpr std::array<int64_t, n> q30_coefficients(const double (&c)[n], double first = 1.0, double scale = 1.0)
+    {
+      std::array<int64_t, n> ret{};
+      double factor = first * static_cast<double>(int64_t{1} << 30);
+      for (size_t i = 0; i < n; ++i)
+      {
+        const double v = c[i] * factor;
+        ret[i] = static_cast<int64_t>(v < 0 ? v - 0.5 : v + 0.5);
+        factor *= scale;
+      }
+      return ret;
+    }
+
+    /**
+     * @brief Evaluates a polynomial whose variable and coefficients are Q30 numbers
+     */
+    template <size_t n>
+    constexpr int64_t horner_q30(int64_t x, const std::array<int64_t, n> &c)
+    {
+      int64_t p = c[n - 1];
+      for (size_t i = n - 1; i-- > 0;)
+      {
+        p = ((p * x) >> 30) + c[i];
+      }
+      return p;
+    }
+
+    /**
+     * @return x rounded to the nearest integer, halfway cases to even, for |x| < 2^(mantissaBits - 1).
+     * Adding 1.5 * 2^mantissaBits leaves no fractional bit, which avoids a float to integer conversion
+     * (conversions to 64 bits integers have no vector instruction before AVX-512)
+     */
+    template <typename T>
+    constexpr T round_nearest(T x)
+    {
+      constexpr T shifter = static_cast<T>(typename FloatTraits<T>::uint_t{3} << (FloatTraits<T>::mantissaBits - 1));
+      return (x + shifter) - shifter;
+    }
+
+    /**
+     * @return x - k * pi, the product being split (Cody-Waite reduction) to remain accurate for large k
+     */
+    template <typename T>
+    constexpr T reduce_pi(T x, T k)
+    {
+      using traits = FloatTraits<T>;
+      return ((x - k * traits::piHi) - k * traits::piMid) - k * traits::piLo;
+    }
+
+    /**
+     * @return condition ? a : b, selected with bit masks: a ternary operator may let the compiler move the computations
+     * depending on the selected value into branches, which are not vectorized when they could raise floating point exceptions
+     */
+    template <typename T>
+    ESUTILS_BIT_CAST_CONSTEXPR T select(bool condition, T a, T b)
+    {
+      using uint_t = typename FloatTraits<T>::uint_t;
+      const uint_t mask = uint_t{0} - static_cast<uint_t>(condition);
+      return bit_cast<T>((bit_cast<uint_t>(a) & mask) | (bit_cast<uint_t>(b) & ~mask));
+    }
+
+    /**
+     * @return (-1)^k * sin(r) for r in [-pi/2, pi/2]
+     */
+    template <Accuracy accuracy, typename T>
+    constexpr T signed_sin(T r, T k)
+    {
+      const T p = r * horner(r * r, FastMathTier<accuracy>::sin);
+      return round_nearest(k * T{0.5}) != k * T{0.5} ? -p : p;
+    }
+  } // namespace detail
+
+  /**
+   * @brief Sine. The argument is reduced to [-pi/2, pi/2] and goes through an odd minimax polynomial.
+   * Maximum absolute error for |x| <= 10^4, double / float: LOW 1.4e-4 / 1.4e-4, MEDIUM 1.5e-6 / 1.6e-6,
+   * HIGH 7e-11 / 1.8e-7
+   * @tparam accuracy the accuracy tier
+   * @param x the angle in radians
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM, typename T>
+  constexpr T fast_sin(T x)
+  {
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point type");
+    const T k = detail::round_nearest(x * static_cast<T>(1.0 / detail::pi));
+    return detail::signed_sin<accuracy>(detail::reduce_pi(x, k), k);
+  }
+
+  /**
+   * @brief Cosine, computed as (-1)^k * sin(x - (k - 1/2) * pi) with the polynomial of fast_sin.
+   * Maximum absolute error: the one of fast_sin
+   * @tparam accuracy the accuracy tier
+   * @param x the angle in radians
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM, typename T>
+  constexpr T fast_cos(T x)
+  {
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point type");
+    const T k = detail::round_nearest(x * static_cast<T>(1.0 / detail::pi) + T{0.5});
+    return detail::signed_sin<accuracy>(detail::reduce_pi(x, k - T{0.5}), k);
+  }
+
+  /**
+   * @brief Base 2 exponential. The integral part of x is added to the exponent of a minimax polynomial
+   * of its fractional part. The result saturates to the smallest and largest normal numbers.
+   * Maximum relative error, double / float: LOW 7.5e-5 / 7.5e-5, MEDIUM 7.5e-8 / 1.6e-7, HIGH 4.1e-11 / 9.3e-8
+   * @tparam accuracy the accuracy tier
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM, typename T>
+  ESUTILS_BIT_CAST_CONSTEXPR T fast_exp2(T x)
+  {
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point type");
+    using traits = detail::FloatTraits<T>;
+    using uint_t = typename traits::uint_t;
+
+    constexpr T lowest = static_cast<T>(1 - traits::bias);
+    constexpr T highest = static_cast<T>(traits::bias) + T{0.5};
+    // As in round_nearest, adding 1.5 * 2^mantissaBits rounds to an integer held in the low bits of the mantissa,
+    // which is added to the exponent of the polynomial. Rounding x - 1/2 gives i with x - i in [0, 1], the range
+    // of the polynomial.
+    constexpr T shifter = static_cast<T>(uint_t{3} << (traits::mantissaBits - 1));
+    const T shifted = (x - T{0.5}) + shifter;
+    const T i = shifted - shifter;
+    const T p = detail::horner(x - i, detail::FastMathTier<accuracy>::exp2);
+    const uint_t exponent = (detail::bit_cast<uint_t>(shifted) - detail::bit_cast<uint_t>(shifter)) << traits::mantissaBits;
+    // Out of range results are masked out afterwards rather than clamping x, so that no computation depends on a condition
+    const uint_t inRange = uint_t{0} - static_cast<uint_t>((x >= lowest) & (x < highest));
+    const uint_t saturated =
+      detail::bit_cast<uint_t>(detail::select(x < lowest, std::numeric_limits<T>::min(), std::numeric_limits<T>::max()));
+    return detail::bit_cast<T>(((detail::bit_cast<uint_t>(p) + exponent) & inRange) | (saturated & ~inRange));
+  }
+
+  /**
+   * @brief Base 2 logarithm of a positive normal number. The exponent is extracted and the mantissa,
+   * brought to [sqrt(1/2), sqrt(2)[, goes through a minimax polynomial.
+   * Maximum absolute error for x in [1e-3, 2e3], double / float: LOW 1.8e-4 / 1.8e-4, MEDIUM 4.4e-7 / 9.4e-7,
+   * HIGH 7.6e-9 / 5.5e-7 (in float, the rounding of the result dominates as |log2(x)| grows)
+   * @tparam accuracy the accuracy tier
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM, typename T>
+  ESUTILS_BIT_CAST_CONSTEXPR T fast_log2(T x)
+  {
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point type");
+    using traits = detail::FloatTraits<T>;
+    using int_t = typename traits::int_t;
+    using uint_t = typename traits::uint_t;
+
+    constexpr uint_t mantissaMask = (uint_t{1} << traits::mantissaBits) - 1;
+    const uint_t bits = detail::bit_cast<uint_t>(x);
+    // Mantissas above sqrt(2) are halved by decrementing their exponent, with integer operations only
+    const bool high = (bits & mantissaMask) > traits::sqrt2Mantissa;
+    const int_t e = static_cast<int_t>(bits >> traits::mantissaBits) - traits::bias + high;
+    const uint_t halved = static_cast<uint_t>(high) << traits::mantissaBits;
+    const T u = detail::bit_cast<T>(((bits & mantissaMask) | detail::bit_cast<uint_t>(T{1})) - halved) - T{1};
+    return u * detail::horner(u, detail::FastMathTier<accuracy>::log2) + static_cast<T>(e);
+  }
+
+  /**
+   * @brief Inverse square root of a positive normal number: an initial guess derived from the representation of x
+   * is refined by 1 (LOW), 2 (MEDIUM) or 3 (HIGH) Newton steps.
+   * Maximum relative error, double / float: LOW 1.8e-3 / 1.8e-3, MEDIUM 4.6e-6 / 4.8e-6, HIGH 3.2e-11 / 1.5e-7
+   * @tparam accuracy the accuracy tier
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM, typename T>
+  ESUTILS_BIT_CAST_CONSTEXPR T fast_inv_sqrt(T x)
+  {
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point type");
+    using traits = detail::FloatTraits<T>;
+    using uint_t = typename traits::uint_t;
+
+    const T halfX = x * T{0.5};
+    T y = detail::bit_cast<T>(traits::invSqrtMagic - (detail::bit_cast<uint_t>(x) >> 1));
+    for (int i = 0; i < detail::FastMathTier<accuracy>::newtonSteps; ++i)
+    {
+      y = y * (T{1.5} - halfX * y * y);
+    }
+    return y;
+  }
+
+  /**
+   * @brief Angle of the vector (x, y) in [-pi, pi]. The ratio of the smaller to the larger coordinate magnitude goes
+   * through an odd minimax polynomial of atan on [0, 1], then the angle is moved to the octant of (x, y).
+   * fast_atan2(0, 0) is 0.
+   * Maximum absolute error, double / float: LOW 2.3e-4 / 2.3e-4, MEDIUM 1e-5 / 1.1e-5, HIGH 1.1e-7 / 3.8e-7
+   * @tparam accuracy the accuracy tier
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM, typename T>
+  ESUTILS_BIT_CAST_CONSTEXPR T fast_atan2(T y, T x)
+  {
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point type");
+    const T ax = x < T{0} ? -x : x;
+    const T ay = y < T{0} ? -y : y;
+    const bool steep = ay > ax;
+    // Adding the smallest normal number makes 0 / 0 give 0 without a conditional division
+    const T a = detail::select(steep, ax, ay) / (detail::select(steep, ay, ax) + std::numeric_limits<T>::min());
+    T r = a * detail::horner(a * a, detail::FastMathTier<accuracy>::atan);
+    // pi/2 - r and pi - r are written as selections of constants followed by unconditional operations, for the same reason
+    r = (steep ? static_cast<T>(detail::pi / 2) : T{0}) + (steep ? T{-1} : T{1}) * r;
+    r = (x < T{0} ? static_cast<T>(detail::pi) : T{0}) + (x < T{0} ? T{-1} : T{1}) * r;
+    return (y < T{0} ? T{-1} : T{1}) * r;
+  }
+
+  /**
+   * @brief Fixed point sine, evaluated with integer arithmetic only
+   * @tparam accuracy the accuracy tier, maximum error LOW 5 LSB, MEDIUM 2 LSB, HIGH 1 LSB
+   * @param angle a binary angle, 65536 being a full turn
+   * @return the sine as a Q15 number in [-32767, 32767]
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM>
+  constexpr int16_t sin_q15(uint16_t angle)
+  {
+    // sin(z * pi/2) = z * P(z^2) for z in [-1, 1], the powers of pi/2 being folded into the coefficients
+    constexpr auto c =
+      detail::q30_coefficients(detail::FastMathTier<accuracy>::sin, detail::pi / 2, detail::pi * detail::pi / 4);
+    int32_t a = angle < 0x8000 ? angle : angle - 0x10000; // Half turn in [-0x8000, 0x8000[
+    a = a > 0x4000 ? 0x8000 - a : a;
+    a = a < -0x4000 ? -0x8000 - a : a;
+    const int64_t z = int64_t{a} * 65536; // Q30 in [-1, 1]
+    const int64_t p = detail::horner_q30((z * z) >> 30, c);
+    const int64_t y = ((z >> 15) * p + (int64_t{1} << 29)) >> 30;
+    return static_cast<int16_t>(y < 32767 ? (y > -32767 ? y : -32767) : 32767);
+  }
+
+  /**
+   * @brief Fixed point cosine, evaluated with integer arithmetic only
+   * @tparam accuracy the accuracy tier, maximum error: the one of sin_q15
+   * @param angle a binary angle, 65536 being a full turn
+   * @return the cosine as a Q15 number in [-32767, 32767]
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM>
+  constexpr int16_t cos_q15(uint16_t angle)
+  {
+    return sin_q15<accuracy>(static_cast<uint16_t>(angle + 0x4000));
+  }
+
+  /**
+   * @brief Fixed point atan2 computed by CORDIC in vectoring mode, with shifts and additions only
+   * (8, 12 or 16 iterations depending on the tier). atan2_cordic(0, 0) is 0.
+   * @tparam accuracy the accuracy tier, maximum error LOW 82 LSB, MEDIUM 6 LSB, HIGH 1 LSB
+   * for vectors longer than 100
+   * @return the angle of the vector (x, y) as a binary angle, 32768 being pi (pi itself wraps around to -32768)
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM>
+  constexpr int16_t atan2_cordic(int32_t y, int32_t x)
+  {
+    constexpr int64_t pi = int64_t{1} << 30;
+    // Half turn rotation of the left half plane, the remaining angle being in [-pi/2, pi/2]
+    int64_t angle = x < 0 ? (y < 0 ? -pi : pi) : 0;
+    int64_t vx = x < 0 ? -int64_t{x} : x;
+    int64_t vy = x < 0 ? -int64_t{y} : y;
+
+    // Scales the vector up to 2^31 so that the shifted coordinates keep their precision
+    const uint64_t magnitude = static_cast<uint64_t>(vx | (vy < 0 ? -vy : vy));
+    const int shift = magnitude != 0 ? countl_zero(magnitude) - 32 : 0;
+    vx = static_cast<int64_t>(static_cast<uint64_t>(vx) << shift);
+    vy = static_cast<int64_t>(static_cast<uint64_t>(vy) << shift);
+
+    for (int i = 0; i < detail::FastMathTier<accuracy>::cordicIterations; ++i)
+    {
+      const int64_t dx = vx >> i;
+      const int64_t dy = vy >> i;
+      const bool positive = vy > 0;
+      vx += positive ? dy : -dy;
+      vy -= positive ? dx : -dx;
+      angle += positive ? detail::cordicAngles[i] : -detail::cordicAngles[i];
+    }
+    angle = magnitude != 0 ? angle : 0;
+    return static_cast<int16_t>(static_cast<uint16_t>((angle + (int64_t{1} << 14)) >> 15));
+  }
+
+  /**
+   * @brief Fixed point base 2 exponential, evaluated with integer arithmetic only
+   * @tparam accuracy the accuracy tier, maximum relative error LOW 7.5e-5, MEDIUM 7.6e-8, HIGH 3e-9 (plus 1 LSB)
+   * @param x a Q16.16 number
+   * @return 2^x as an unsigned Q16.16 number, saturated to UINT32_MAX
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM>
+  constexpr uint32_t exp2_q16(int32_t x)
+  {
+    constexpr auto c = detail::q30_coefficients(detail::FastMathTier<accuracy>::exp2);
+    constexpr int64_t saturated = std::numeric_limits<uint32_t>::max();
+    const int32_t i = x >> 16;                                         // Rounded towards -infinity
+    const int64_t p = detail::horner_q30(int64_t{x & 0xFFFF} << 14, c); // Q30 in [1, 2]
+    // p * 2^i in Q16.16, the shift being bounded so that tiny results round to 0 and huge ones saturate
+    const int shift = 14 - (i < 16 ? (i > -48 ? i : -48) : 17);
+    const int64_t v = shift > 0 ? (p + (int64_t{1} << (shift - 1))) >> shift : p << -shift;
+    return static_cast<uint32_t>(v < saturated ? v : saturated);
+  }
+
+  /**
+   * @brief Fixed point base 2 logarithm, evaluated with integer arithmetic only
+   * @tparam accuracy the accuracy tier, maximum error LOW 12 LSB, MEDIUM and HIGH 1 LSB
+   * @param x an unsigned Q16.16 number
+   * @return log2(x) as a Q16.16 number, INT32_MIN for x == 0
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM>
+  constexpr int32_t log2_q16(uint32_t x)
+  {
+    constexpr auto c = detail::q30_coefficients(detail::FastMathTier<accuracy>::log2);
+    int e = 31 - countl_zero(x);
+    int64_t m = static_cast<int64_t>((uint64_t{x} << 30) >> (e & 31)); // Q30 in [1, 2[
+    const bool high = m >= 1518500250;                                  // sqrt(2) in Q30
+    m = high ? m >> 1 : m;
+    e += high ? 1 : 0;
+    const int64_t u = m - (int64_t{1} << 30);
+    const int64_t r = (u * detail::horner_q30(u, c)) >> 30;
+    const int64_t y = (e - 16) * int64_t{65536} + ((r + (int64_t{1} << 13)) >> 14);
+    return x != 0 ? static_cast<int32_t>(y) : std::numeric_limits<int32_t>::min();
+  }
+
+  /**
+   * @brief Batch sine, fast_sin applied to the n elements of in, the results being stored in out
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM, typename T>
+  constexpr void fast_sin(const T *in, T *out, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = fast_sin<accuracy>(in[i]);
+  }
+
+  /**
+   * @brief Batch cosine, fast_cos applied to the n elements of in, the results being stored in out
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM, typename T>
+  constexpr void fast_cos(const T *in, T *out, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = fast_cos<accuracy>(in[i]);
+  }
+
+  /**
+   * @brief Batch base 2 exponential, fast_exp2 applied to the n elements of in, the results being stored in out
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM, typename T>
+  ESUTILS_BIT_CAST_CONSTEXPR void fast_exp2(const T *in, T *out, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = fast_exp2<accuracy>(in[i]);
+  }
+
+  /**
+   * @brief Batch base 2 logarithm, fast_log2 applied to the n elements of in, the results being stored in out
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM, typename T>
+  ESUTILS_BIT_CAST_CONSTEXPR void fast_log2(const T *in, T *out, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = fast_log2<accuracy>(in[i]);
+  }
+
+  /**
+   * @brief Batch inverse square root, fast_inv_sqrt applied to the n elements of in, the results being stored in out
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM, typename T>
+  ESUTILS_BIT_CAST_CONSTEXPR void fast_inv_sqrt(const T *in, T *out, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = fast_inv_sqrt<accuracy>(in[i]);
+  }
+
+  /**
+   * @brief Batch atan2, fast_atan2 applied to the n pairs (y[i], x[i]), the results being stored in out
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM, typename T>
+  ESUTILS_BIT_CAST_CONSTEXPR void fast_atan2(const T *y, const T *x, T *out, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = fast_atan2<accuracy>(y[i], x[i]);
+  }
+
+  /**
+   * @brief Batch fixed point sine, sin_q15 applied to the n elements of in, the results being stored in out
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM>
+  constexpr void sin_q15(const uint16_t *in, int16_t *out, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = sin_q15<accuracy>(in[i]);
+  }
+
+  /**
+   * @brief Batch fixed point cosine, cos_q15 applied to the n elements of in, the results being stored in out
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM>
+  constexpr void cos_q15(const uint16_t *in, int16_t *out, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = cos_q15<accuracy>(in[i]);
+  }
+
+  /**
+   * @brief Batch fixed point atan2, atan2_cordic applied to the n pairs (y[i], x[i]), the results being stored in out
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM>
+  constexpr void atan2_cordic(const int32_t *y, const int32_t *x, int16_t *out, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = atan2_cordic<accuracy>(y[i], x[i]);
+  }
+
+  /**
+   * @brief Batch fixed point base 2 exponential, exp2_q16 applied to the n elements of in, the results being stored in out
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM>
+  constexpr void exp2_q16(const int32_t *in, uint32_t *out, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = exp2_q16<accuracy>(in[i]);
+  }
+
+  /**
+   * @brief Batch fixed point base 2 logarithm, log2_q16 applied to the n elements of in, the results being stored in out
+   */
+  template <Accuracy accuracy = Accuracy::MEDIUM>
+  constexpr void log2_q16(const uint32_t *in, int32_t *out, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = log2_q16<accuracy>(in[i]);
+  }
+} // namespace esutils
+
+#undef ESUTILS_BIT_CAST_CONSTEXPR
+#undef ESUTILS_HAS_BUILTIN_BIT_CAST
+
+#endif // ESUTILS_FAST_MATH_HPP
@@ -0,0 +1,505 @@
+#ifndef ESUTILS_FILTERS_HPP
+#define ESUTILS_FILTERS_HPP
+
+/**
+ * @file filters.hpp
+ * Definition of streaming filters with a number of taps fixed at compile time: FirFilter, BiquadFilter and MovingAverage,
+ * working on float / double samples or on Q15 (int16_t) / Q31 (int32_t) fixed point samples,
+ * and of the MirroredDelayLine keeping their history
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "type_capacity.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief Arithmetic used by the filters for a sample type.
+   * Floating point samples are multiplied by coefficients of the same type. int16_t (Q15) and int32_t (Q31) samples are
+   * multiplied by fixed point coefficients of the same width and accumulated in an int64_t, each product being shifted
+   * right by productShift bits first so that at least 2^15 products can be summed without overflow.
+   * Results are rounded to nearest and saturated.
+   */
+  template <typename T>
+  struct FilterArithmetic
+  {
+    static_assert(std::is_floating_point_v<T>, "Samples must be floating point numbers, int16_t (Q15) or int32_t (Q31)");
+    using coeff_t = T;
+    using acc_t = T;
+
+    static constexpr acc_t multiply(T sample, coeff_t coefficient)
+    {
+      return sample * coefficient;
+    }
+
+    template <int fractionBits>
+    static constexpr T output(acc_t acc)
+    {
+      return acc;
+    }
+
+    template <int fractionBits, typename C>
+    static constexpr coeff_t coefficient(C c)
+    {
+      return static_cast<coeff_t>(c);
+    }
+  };
+
+  namespace detail
+  {
+    template <typename T, int shift>
+    struct FixedFilterArithmetic
+    {
+      using coeff_t = T;
+      using acc_t = int64_t;
+      static constexpr int productShift = shift;
+
+      static constexpr acc_t multiply(T sample, coeff_t coefficient)
+      {
+        return (acc_t{sample} * coefficient) >> productShift;
+      }
+
+      /**
+       * @param acc a sum of products by coefficients having fractionBits fractional bits
+       */
+      template <int fractionBits>
+      static constexpr T output(acc_t acc)
+      {
+        constexpr int outputShift = fractionBits - productShift;
+        const acc_t v = (acc + (acc_t{1} << (outputShift - 1))) >> outputShift;
+        return static_cast<T>(v < std::numeric_limits<T>::min()
+                                ? std::numeric_limits<T>::min()
+                                : (v > std::numeric_limits<T>::max() ? std::numeric_limits<T>::max() : v));
+      }
+
+      /**
+       * @return c as a coefficient with fractionBits fractional bits if it is a floating point number, else c itself
+       */
+      template <int fractionBits, typename C>
+      static constexpr coeff_t coefficient(C c)
+      {
+        if constexpr (std::is_floating_point_v<C>)
+        {
+          const double v = static_cast<double>(c) * static_cast<double>(int64_t{1} << fractionBits);
+          const double lowest = std::numeric_limits<T>::min();
+          const double highest = std::numeric_limits<T>::max();
+          return static_cast<coeff_t>(v < lowest ? lowest : (v > highest ? highest : (v < 0 ? v - 0.5 : v + 0.5)));
+        }
+        else
+        {
+          return static_cast<coeff_t>(c);
+        }
+      }
+    };
+  } // namespace detail
+
+  template <>
+  struct FilterArithmetic<int16_t> : detail::FixedFilterArithmetic<int16_t, 0>
+  {
+  };
+
+  template <>
+  struct FilterArithmetic<int32_t> : detail::FixedFilterArithmetic<int32_t, 16>
+  {
+  };
+
+  /**
+   * @brief A delay line keeping the last length samples. Every sample is written twice, length positions apart,
+   * so that the last length samples are always contiguous in memory, from the oldest to the newest,
+   * and can be read by a plain loop without wrapping around.
+   * @tparam T the type of the samples
+   * @tparam length the number of samples kept
+   */
+  template <typename T, size_t length>
+  class MirroredDelayLine
+  {
+    static_assert(length > 0, "The delay line must keep at least one sample");
+
+  public:
+    constexpr MirroredDelayLine() = default;
+
+    /**
+     * @brief Adds a sample, the oldest one being dropped
+     */
+    constexpr void push(const T &sample)
+    {
+      mData[mPos] = sample;
+      mData[mPos + length] = sample;
+      mPos = mPos + 1 == length ? 0 : mPos + 1;
+    }
+
+    /**
+     * @brief Adds count samples, from the oldest to the newest
+     */
+    constexpr void push(const T *samples, size_t count)
+    {
+      for (size_t i = 0; i < count; ++i)
+        push(samples[i]);
+    }
+
+    /**
+     * @return a pointer to the last length samples, from the oldest to the newest
+     */
+    constexpr const T *window() const
+    {
+      return mData + mPos;
+    }
+
+    /**
+     * @param age the number of samples pushed after the requested one, in the range [0, size()[
+     * @return a copy of the sample
+     */
+    constexpr T operator[](size_t age) const
+    {
+      return mData[mPos + length - 1 - age];
+    }
+
+    /**
+     * @return the number of samples kept
+     */
+    constexpr size_t size() const
+    {
+      return length;
+    }
+
+    /**
+     * @brief Resets every sample to T{}
+     */
+    constexpr void clear()
+    {
+      for (size_t i = 0; i < 2 * length; ++i)
+        mData[i] = T{};
+      mPos = 0;
+    }
+
+  private:
+    T mData[2 * length]{};
+    typename TypeCapacity<length>::type mPos = 0;
+  };
+
+  /**
+   * @brief A finite impulse response filter: y[n] = sum over k of h[k] * x[n - k].
+   * Fixed point coefficients have the format of the samples (Q15 for int16_t, Q31 for int32_t), so |h[k]| < 1.
+   * The block version processes up to blockSize samples at once with the taps in the outer loop
+   * and the samples in the inner loop: the inner loop has no loop-carried dependency, so the compiler vectorizes it
+   * (float sums are not reordered, the block and sample by sample versions give identical results).
+   * @tparam T the type of the samples
+   * @tparam taps the number of coefficients
+   */
+  template <typename T, size_t taps>
+  class FirFilter
+  {
+    static_assert(taps > 0, "The filter needs at least one coefficient");
+
+    using arithmetic = FilterArithmetic<T>;
+    using coeff_t = typename arithmetic::coeff_t;
+    using acc_t = typename arithmetic::acc_t;
+
+    static constexpr int fractionBits = std::numeric_limits<T>::digits;
+    static constexpr size_t blockSize = 32;
+
+  public:
+    /**
+     * @brief Constructor
+     * @param coefficients the impulse response h, h[0] applying to the newest sample. Floating point coefficients of
+     * a fixed point filter are converted, integral ones are taken as fixed point numbers
+     */
+    template <typename C>
+    constexpr FirFilter(const C (&coefficients)[taps])
+    {
+      for (size_t k = 0; k < taps; ++k)
+        mCoefficients[k] = arithmetic::template coefficient<fractionBits>(coefficients[k]);
+    }
+
+    /**
+     * @brief Filters a sample
+     * @return the output sample
+     */
+    constexpr T process(T sample)
+    {
+      mDelay.push(sample);
+      const T *x = mDelay.window();
+      acc_t acc{};
+      for (size_t k = 0; k < taps; ++k)
+        acc += arithmetic::multiply(x[taps - 1 - k], mCoefficients[k]);
+      return arithmetic::template output<fractionBits>(acc);
+    }
+
+    /**
+     * @brief Filters count samples. in and out may be the same array
+     */
+    constexpr void process(const T *in, T *out, size_t count)
+    {
+      for (size_t start = 0; start < count; start += blockSize)
+      {
+        const size_t n = count - start < blockSize ? count - start : blockSize;
+
+        // The last taps - 1 samples followed by the block
+        T x[taps - 1 + blockSize]{};
+        const T *history = mDelay.window() + 1;
+        for (size_t i = 0; i + 1 < taps; ++i)
+          x[i] = history[i];
+        for (size_t i = 0; i < n; ++i)
+          x[taps - 1 + i] = in[start + i];
+
+        acc_t acc[blockSize]{};
+        for (size_t k = 0; k < taps; ++k)
+        {
+          const coeff_t h = mCoefficients[k];
+          const T *delayed = x + (taps - 1 - k);
+          for (size_t i = 0; i < n; ++i)
+            acc[i] += arithmetic::multiply(delayed[i], h);
+        }
+        for (size_t i = 0; i < n; ++i)
+          out[start + i] = arithmetic::template output<fractionBits>(acc[i]);
+        mDelay.push(x + taps - 1, n);
+      }
+    }
+
+    /**
+     * @param k the index of a coefficient in the range [0, size()[
+     * @return the coefficient applying to the sample delayed by k
+     */
+    constexpr coeff_t operator[](size_t k) const
+    {
+      return mCoefficients[k];
+    }
+
+    /**
+     * @return the number of coefficients
+     */
+    constexpr size_t size() const
+    {
+      return taps;
+    }
+
+    /**
+     * @brief Resets the history to zeros
+     */
+    constexpr void clear()
+    {
+      mDelay.clear();
+    }
+
+  private:
+    coeff_t mCoefficients[taps]{};
+    MirroredDelayLine<T, taps> mDelay;
+  };
+
+  /**
+   * @brief A cascade of second order infinite impulse response sections (biquads), each one computing
+   * y[n] = b0 * x[n] + b1 * x[n - 1] + b2 * x[n - 2] - a1 * y[n - 1] - a2 * y[n - 2] in direct form I,
+   * which needs a single accumulator and suits fixed point arithmetic.
+   * Fixed point coefficients have one integral bit (Q14 for int16_t samples, Q30 for int32_t) so that they
+   * can reach [-2, 2[, and every section saturates its output.
+   * The block version runs each section over the whole block before the next one.
+   * @tparam T the type of the samples
+   * @tparam stages the number of sections
+   */
+  template <typename T, size_t stages = 1>
+  class BiquadFilter
+  {
+    static_assert(stages > 0, "The filter needs at least one section");
+
+    using arithmetic = FilterArithmetic<T>;
+    using coeff_t = typename arithmetic::coeff_t;
+    using acc_t = typename arithmetic::acc_t;
+
+    static constexpr int fractionBits = std::numeric_limits<T>::digits - 1;
+
+    struct Section
+    {
+      coeff_t b0, b1, b2, a1, a2;
+      T x1, x2, y1, y2;
+    };
+
+  public:
+    /**
+     * @brief Constructor
+     * @param coefficients the coefficients {b0, b1, b2, a1, a2} of each section, a0 being 1. Floating point coefficients
+     * of a fixed point filter are converted, integral ones are taken as fixed point numbers
+     */
+    template <typename C>
+    constexpr BiquadFilter(const C (&coefficients)[stages][5])
+    {
+      for (size_t s = 0; s < stages; ++s)
+        set_coefficients(mSections[s], coefficients[s]);
+    }
+
+    /**
+     * @brief Constructor of a single section filter
+     */
+    template <typename C, size_t n = stages, std::enable_if_t<n == 1, int> = 0>
+    constexpr BiquadFilter(const C (&coefficients)[5])
+    {
+      set_coefficients(mSections[0], coefficients);
+    }
+
+    /**
+     * @brief Filters a sample
+     * @return the output sample
+     */
+    constexpr T process(T sample)
+    {
+      for (size_t s = 0; s < stages; ++s)
+        sample = step(mSections[s], sample);
+      return sample;
+    }
+
+    /**
+     * @brief Filters count samples. in and out may be the same array
+     */
+    constexpr void process(const T *in, T *out, size_t count)
+    {
+      const T *source = in;
+      for (size_t s = 0; s < stages; ++s)
+      {
+        Section section = mSections[s]; // Local copy so that the state stays in registers
+        for (size_t i = 0; i < count; ++i)
+          out[i] = step(section, source[i]);
+        mSections[s] = section;
+        source = out;
+      }
+    }
+
+    /**
+     * @brief Resets the state of every section to zeros
+     */
+    constexpr void clear()
+    {
+      for (Section &section : mSections)
+        section.x1 = section.x2 = section.y1 = section.y2 = T{};
+    }
+
+  private:
+    template <typename C>
+    static constexpr void set_coefficients(Section &s, const C (&coefficients)[5])
+    {
+      s.b0 = arithmetic::template coefficient<fractionBits>(coefficients[0]);
+      s.b1 = arithmetic::template coefficient<fractionBits>(coefficients[1]);
+      s.b2 = arithmetic::template coefficient<fractionBits>(coefficients[2]);
+      s.a1 = arithmetic::template coefficient<fractionBits>(coefficients[3]);
+      s.a2 = arithmetic::template coefficient<fractionBits>(coefficients[4]);
+    }
+
+    static constexpr T step(Section &s, T x)
+    {
+      acc_t acc = arithmetic::multiply(x, s.b0);
+      acc += arithmetic::multiply(s.x1, s.b1);
+      acc += arithmetic::multiply(s.x2, s.b2);
+      acc -= arithmetic::multiply(s.y1, s.a1);
+      acc -= arithmetic::multiply(s.y2, s.a2);
+      const T y = arithmetic::template output<fractionBits>(acc);
+      s.x2 = s.x1;
+      s.x1 = x;
+      s.y2 = s.y1;
+      s.y1 = y;
+      return y;
+    }
+
+    Section mSections[stages]{};
+  };
+
+  /**
+   * @brief The mean of the last length samples, updated in constant time with a running sum.
+   * Integral samples are summed in a 64 bits integer and the mean is rounded to nearest. A floating point running sum
+   * is recomputed from the delay line every length samples so that rounding errors do not accumulate.
+   * The history starts filled with zeros.
+   * @tparam T the type of the samples
+   * @tparam length the number of samples averaged
+   */
+  template <typename T, size_t length>
+  class MovingAverage
+  {
+    static_assert(std::is_arithmetic_v<T>, "T must be an arithmetic type");
+    static_assert(length > 0, "At least one sample must be averaged");
+
+    using sum_t = std::conditional_t<std::is_floating_point_v<T>, T,
+                                     std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+  public:
+    constexpr MovingAverage() = default;
+
+    /**
+     * @brief Adds a sample
+     * @return the mean of the last length samples
+     */
+    constexpr T process(T sample)
+    {
+      const T oldest = mDelay.window()[0];
+      mDelay.push(sample);
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        if (++mSinceResum == length)
+        {
+          mSinceResum = 0;
+          mSum = sum_t{};
+          for (size_t i = 0; i < length; ++i)
+            mSum += mDelay.window()[i];
+        }
+        else
+        {
+          mSum += sample - oldest;
+        }
+      }
+      else
+      {
+        mSum += static_cast<sum_t>(sample) - static_cast<sum_t>(oldest);
+      }
+      return mean();
+    }
+
+    /**
+     * @brief Adds count samples. in and out may be the same array
+     */
+    constexpr void process(const T *in, T *out, size_t count)
+    {
+      for (size_t i = 0; i < count; ++i)
+        out[i] = process(in[i]);
+    }
+
+    /**
+     * @return the mean of the last length samples
+     */
+    constexpr T mean() const
+    {
+      if constexpr (std::is_floating_point_v<T>)
+        return mSum * (T{1} / static_cast<T>(length));
+      else if constexpr (std::is_signed_v<T>)
+        return static_cast<T>(mSum < 0 ? -((-mSum + static_cast<sum_t>(length / 2)) / static_cast<sum_t>(length))
+                                       : (mSum + static_cast<sum_t>(length / 2)) / static_cast<sum_t>(length));
+      else
+        return static_cast<T>((mSum + length / 2) / length);
+    }
+
+    /**
+     * @return the sum of the last length samples
+     */
+    constexpr sum_t sum() const
+    {
+      return mSum;
+    }
+
+    /**
+     * @brief Resets the history to zeros
+     */
+    constexpr void clear()
+    {
+      mDelay.clear();
+      mSum = sum_t{};
+      mSinceResum = 0;
+    }
+
+  private:
+    MirroredDelayLine<T, length> mDelay;
+    sum_t mSum{};
+    size_t mSinceResum = 0;
+  };
+} // namespace esutils
+
+#endif // ESUTILS_FILTERS_HPP
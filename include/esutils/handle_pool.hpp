@@ -0,0 +1,107 @@
+#ifndef ESUTILS_HANDLE_POOL_HPP
+#define ESUTILS_HANDLE_POOL_HPP
+
+/**
+ * @file handle_pool.hpp
+ * Definition of HandlePool, the allocator of the handles given out by the containers with stable handles
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "bit_operations.hpp"
+#include "static_stack.hpp"
+#include "type_capacity.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief Hands out the handles of cty slots. The low bits of a handle are the index of its slot and the high bits a
+   * generation, incremented each time the slot is released: a handle kept after its element left the container no
+   * longer matches its slot, even once the slot is reused (until the generation of the slot wraps around, after
+   * 2^(32 - bits of cty) releases).
+   * Released slots are reused last in first out, the slots never used are handed out in order.
+   * @tparam cty the number of slots
+   */
+  template <size_t cty>
+  class HandlePool
+  {
+    static constexpr int indexBits = std::numeric_limits<uint32_t>::digits - countl_zero(uint32_t{cty});
+    static_assert(cty > 0 && indexBits < 24, "The capacity leaves too few bits to the generation of the handles");
+
+  public:
+    using handle_t = uint32_t;
+    using index_t = typename TypeCapacity<cty>::type;
+
+    /**
+     * @brief A handle matching no slot: its index is cty
+     */
+    static constexpr handle_t INVALID_HANDLE = cty;
+
+    HandlePool()
+    {
+      for (size_t i = 0; i < cty; ++i)
+        mHandles[i] = i;
+    }
+
+    /**
+     * @brief Takes a free slot, there must be one
+     * @return the handle of the slot
+     */
+    handle_t acquire()
+    {
+      const index_t slot = mFree.pop().value_or(mUsed);
+      ++mUsed;
+      return mHandles[slot];
+    }
+
+    /**
+     * @brief Gives a slot back, the handles given out for it stop matching it
+     * @param slot the index of a slot taken by acquire
+     */
+    void release(index_t slot)
+    {
+      mHandles[slot] += handle_t{1} << indexBits;
+      mFree.push(slot);
+      --mUsed;
+    }
+
+    /**
+     * @param handle any handle
+     * @return true if handle is the current handle of its slot. The slot may be free if it was never taken
+     */
+    bool matches(handle_t handle) const
+    {
+      const size_t slot = index(handle);
+      return slot < cty && mHandles[slot] == handle;
+    }
+
+    /**
+     * @param slot the index of a slot
+     * @return the current handle of the slot
+     */
+    handle_t handle(index_t slot) const
+    {
+      return mHandles[slot];
+    }
+
+    /**
+     * @param handle any handle
+     * @return the index of the slot of the handle, cty for INVALID_HANDLE
+     */
+    static constexpr index_t index(handle_t handle)
+    {
+      return handle & ((handle_t{1} << indexBits) - 1);
+    }
+
+  private:
+    handle_t mHandles[cty]{};
+    // While no slot is free the slots in use are [0, mUsed[, so that the never used slots need no free list entry
+    StaticStack<index_t, cty> mFree;
+    index_t mUsed = 0;
+  };
+} // namespace esutils
+
+#endif // ESUTILS_HANDLE_POOL_HPP
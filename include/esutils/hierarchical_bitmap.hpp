@@ -0,0 +1,219 @@
+#ifndef ESUTILS_HIERARCHICAL_BITMAP_HPP
+#define ESUTILS_HIERARCHICAL_BITMAP_HPP
+
+/**
+ * @file hierarchical_bitmap.hpp
+ * Definition of a fixed size bitmap with summary levels allowing to find set bits in O(log64(sz))
+ * @author Etienne Santoul
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "bit_operations.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief A bitmap of sz bits with summary levels.
+   * Bit i of a word at level l + 1 is set if word i of level l is not zero. Level 0 holds the actual bits.
+   * This allows finding the first / next set bit by looking at a single word per level,
+   * i.e. 2 words for up to 4096 bits, 3 words for up to 262144 bits.
+   * All the levels are stored in a single fixed size array, no heap allocation is performed.
+   * @tparam sz the number of bits in the bitmap
+   */
+  template <size_t sz>
+  class HierarchicalBitmap
+  {
+    static_assert(sz > 0, "HierarchicalBitmap must contain at least one bit");
+
+    using word_t = uint64_t;
+    static constexpr size_t wordBits = 64;
+    static constexpr size_t wordShift = 6;
+
+    static constexpr size_t words_at_level(size_t level)
+    {
+      size_t count = (sz + wordBits - 1) / wordBits;
+      for (size_t l = 0; l < level; ++l)
+        count = (count + wordBits - 1) / wordBits;
+      return count;
+    }
+
+    static constexpr size_t level_count()
+    {
+      size_t count = 1;
+      while (words_at_level(count - 1) > 1)
+        ++count;
+      return count;
+    }
+
+    static constexpr size_t levels = level_count();
+
+    static constexpr size_t level_offset(size_t level)
+    {
+      size_t offset = 0;
+      for (size_t l = 0; l < level; ++l)
+        offset += words_at_level(l);
+      return offset;
+    }
+
+    static constexpr size_t totalWords = level_offset(levels);
+
+    template <size_t... l>
+    static constexpr std::array<size_t, levels> make_offsets(std::index_sequence<l...>)
+    {
+      return {level_offset(l)...};
+    }
+
+    template <size_t... l>
+    static constexpr std::array<size_t, levels> make_level_bits(std::index_sequence<l...>)
+    {
+      return {(words_at_level(l) * wordBits)...};
+    }
+
+    // Precomputed so that runtime level loops only read constants
+    static constexpr std::array<size_t, levels> offsets = make_offsets(std::make_index_sequence<levels>{});
+    static constexpr std::array<size_t, levels> levelBits = make_level_bits(std::make_index_sequence<levels>{});
+
+  public:
+    /**
+     * @brief Default constructor, all bits are cleared
+     */
+    constexpr HierarchicalBitmap() = default;
+
+    /**
+     * @return the number of bits in the bitmap
+     */
+    constexpr size_t size() const
+    {
+      return sz;
+    }
+
+    /**
+     * @param index the index of the bit
+     * @return the value of the bit
+     */
+    constexpr bool test(size_t index) const
+    {
+      return (mWords[index >> wordShift] >> (index & (wordBits - 1))) & 1;
+    }
+
+    /**
+     * @brief Array subscript operator
+     * @param index the index of the desired bit
+     * @return the value of the bit
+     */
+    constexpr bool operator[](size_t index) const
+    {
+      return test(index);
+    }
+
+    /**
+     * @brief Sets a bit to true
+     * @param index the index of the bit
+     */
+    constexpr void set(size_t index)
+    {
+      for (size_t l = 0; l < levels; ++l)
+      {
+        word_t &word = mWords[offsets[l] + (index >> wordShift)];
+        const bool wasEmpty = word == 0;
+        word |= word_t{1} << (index & (wordBits - 1));
+        if (!wasEmpty) // Upper levels already know this word is not empty
+          return;
+        index >>= wordShift;
+      }
+    }
+
+    /**
+     * @brief Sets a bit to false
+     * @param index the index of the bit
+     */
+    constexpr void reset(size_t index)
+    {
+      for (size_t l = 0; l < levels; ++l)
+      {
+        word_t &word = mWords[offsets[l] + (index >> wordShift)];
+        word &= ~(word_t{1} << (index & (wordBits - 1)));
+        if (word != 0) // Word still not empty so upper levels stay unchanged
+          return;
+        index >>= wordShift;
+      }
+    }
+
+    /**
+     * @brief Sets every bit to false
+     */
+    constexpr void clear()
+    {
+      for (size_t i = 0; i < totalWords; ++i)
+      {
+        mWords[i] = 0;
+      }
+    }
+
+    /**
+     * @return true if no bit is set
+     */
+    constexpr bool none() const
+    {
+      return mWords[offsets[levels - 1]] == 0;
+    }
+
+    /**
+     * @return the index of the first set bit or sz if no bit is set
+     */
+    constexpr size_t find_first() const
+    {
+      if (none())
+        return sz;
+      return descend(levels - 1, 0);
+    }
+
+    /**
+     * @param index the index after which to start the search
+     * @return the index of the first set bit strictly after index or sz if there is none
+     */
+    constexpr size_t find_next(size_t index) const
+    {
+      ++index;
+      for (size_t l = 0; l < levels; ++l)
+      {
+        if (index >= levelBits[l])
+          return sz;
+
+        const word_t word = mWords[offsets[l] + (index >> wordShift)] & (~word_t{0} << (index & (wordBits - 1)));
+        if (word != 0)
+        {
+          const size_t found = (index & ~(wordBits - 1)) + countr_zero(word);
+          return l == 0 ? found : descend(l - 1, found);
+        }
+
+        // Nothing left in this word, look for the next non empty word one level up
+        index = (index >> wordShift) + 1;
+      }
+      return sz;
+    }
+
+  private:
+    /**
+     * @brief Follows the lowest set bits from a non empty word down to level 0
+     * @param level the level of the word
+     * @param wordIndex the index of the word in its level
+     */
+    constexpr size_t descend(size_t level, size_t wordIndex) const
+    {
+      for (size_t l = level + 1; l-- > 0;)
+      {
+        wordIndex = (wordIndex << wordShift) + countr_zero(mWords[offsets[l] + wordIndex]);
+      }
+      return wordIndex;
+    }
+
+    word_t mWords[totalWords]{};
+  };
+} // namespace esutils
+
+#endif // ESUTILS_HIERARCHICAL_BITMAP_HPP
@@ -0,0 +1,181 @@
+#ifndef ESUTILS_INSTRUMENTATION_HPP
+#define ESUTILS_INSTRUMENTATION_HPP
+
+/**
+ * @file instrumentation.hpp
+ * Definition of the instrumentation policies of the containers, which record how close to their capacity they run
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace esutils
+{
+  /**
+   * @brief The events counted by the containers for each element
+   */
+  enum class ContainerEvent : uint8_t
+  {
+    INSERTED,    // An element was added (write, push, insert)
+    REMOVED,     // An element was removed (read, pop, erase)
+    REJECTED,    // An element could not be added because the container was full
+    OVERWRITTEN, // An element was lost to make room for a new one
+  };
+
+  /**
+   * @brief The state of an instrumented container, plain data that the host can dump as is
+   */
+  struct ContainerSnapshot
+  {
+    size_t capacity = 0;
+    size_t size = 0;
+    size_t highWaterMark = 0; // The largest size reached
+    uint32_t operations = 0;  // Calls to the instrumented member functions
+    uint32_t insertions = 0;
+    uint32_t removals = 0;
+    uint32_t rejections = 0;
+    uint32_t overwrites = 0;
+    uint64_t totalCycles = 0; // Time spent in the instrumented operations, 0 if they are not timed
+    uint64_t maxCycles = 0;   // Longest instrumented operation, 0 if they are not timed
+  };
+
+  /**
+   * @brief The default instrumentation policy: it records nothing and is an empty base of the containers, so it costs
+   * neither memory nor time.
+   * A policy provides a timestamp_t type, start() called at the beginning of an operation, count(event, n) called for
+   * the elements it affects and finish(size, start) called at its end with the resulting size of the container
+   */
+  class NoInstrumentation
+  {
+  public:
+    struct timestamp_t
+    {
+    };
+
+    constexpr timestamp_t start() const
+    {
+      return {};
+    }
+
+    constexpr void count(ContainerEvent, size_t = 1) {}
+
+    constexpr void finish(size_t, timestamp_t) {}
+
+    /**
+     * @param capacity the capacity of the container
+     * @param size the current size of the container
+     * @return a snapshot with the capacity and the size only
+     */
+    constexpr ContainerSnapshot snapshot(size_t capacity, size_t size) const
+    {
+      ContainerSnapshot s;
+      s.capacity = capacity;
+      s.size = size;
+      return s;
+    }
+
+    constexpr void reset() {}
+  };
+
+  namespace detail
+  {
+    template <typename CycleCounter>
+    struct CycleTimestamp
+    {
+      using type = decltype(CycleCounter::now());
+    };
+
+    template <>
+    struct CycleTimestamp<void>
+    {
+      using type = NoInstrumentation::timestamp_t;
+    };
+  } // namespace detail
+
+  /**
+   * @brief An instrumentation policy counting the events of a container and keeping its high-water mark
+   * @tparam CycleCounter void to disable the timing of the operations, or a type whose static now() returns an
+   * unsigned free running counter, e.g. a read of the DWT cycle counter on Cortex-M
+   */
+  template <typename CycleCounter = void>
+  class ContainerStatistics
+  {
+    static constexpr bool timed = !std::is_void_v<CycleCounter>;
+
+  public:
+    using timestamp_t = typename detail::CycleTimestamp<CycleCounter>::type;
+
+    constexpr timestamp_t start() const
+    {
+      if constexpr (timed)
+        return CycleCounter::now();
+      else
+        return {};
+    }
+
+    constexpr void count(ContainerEvent event, size_t n = 1)
+    {
+      mCounts[static_cast<uint8_t>(event)] += n;
+    }
+
+    constexpr void finish(size_t size, timestamp_t begin)
+    {
+      if constexpr (timed)
+      {
+        // Converted back to the counter type so that the difference wraps around like the counter
+        const timestamp_t elapsed = CycleCounter::now() - begin;
+        mTotalCycles += elapsed;
+        if (elapsed > mMaxCycles)
+          mMaxCycles = elapsed;
+      }
+      ++mOperations;
+      if (size > mHighWaterMark)
+        mHighWaterMark = size;
+    }
+
+    /**
+     * @param capacity the capacity of the container
+     * @param size the current size of the container
+     * @return the recorded statistics
+     */
+    constexpr ContainerSnapshot snapshot(size_t capacity, size_t size) const
+    {
+      ContainerSnapshot s;
+      s.capacity = capacity;
+      s.size = size;
+      s.highWaterMark = mHighWaterMark;
+      s.operations = mOperations;
+      s.insertions = mCounts[static_cast<uint8_t>(ContainerEvent::INSERTED)];
+      s.removals = mCounts[static_cast<uint8_t>(ContainerEvent::REMOVED)];
+      s.rejections = mCounts[static_cast<uint8_t>(ContainerEvent::REJECTED)];
+      s.overwrites = mCounts[static_cast<uint8_t>(ContainerEvent::OVERWRITTEN)];
+      s.totalCycles = mTotalCycles;
+      s.maxCycles = mMaxCycles;
+      return s;
+    }
+
+    /**
+     * @brief Clears the statistics, the high-water mark starts again from the next operation
+     */
+    constexpr void reset()
+    {
+      for (auto &count : mCounts)
+        count = 0;
+      mHighWaterMark = 0;
+      mOperations = 0;
+      mTotalCycles = 0;
+      mMaxCycles = 0;
+    }
+
+  private:
+    uint32_t mCounts[4]{};
+    size_t mHighWaterMark = 0;
+    uint32_t mOperations = 0;
+    uint64_t mTotalCycles = 0;
+    uint64_t mMaxCycles = 0;
+  };
+} // namespace esutils
+
+#endif // ESUTILS_INSTRUMENTATION_HPP
@@ -0,0 +1,178 @@
+#ifndef ESUTILS_INTERPOLATING_LOOKUP_TABLE_HPP
+#define ESUTILS_INTERPOLATING_LOOKUP_TABLE_HPP
+
+/**
+ * @file interpolating_lookup_table.hpp
+ * Definition of the InterpolatingLookUpTable class. This class samples a function over an interval at compile time
+ * and evaluates it at any point of the interval by linear interpolation.
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "interpolation.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief A lookup table sampling a function at 2^log2Segments + 1 evenly spaced points of [xmin, xmax],
+   * evaluated by linear interpolation between the two samples surrounding the input. Inputs outside of
+   * [xmin, xmax] are clamped.
+   * The lookup path has no division: an integral input is scaled to a fixed point table position with a precomputed
+   * multiplier, a floating point one is multiplied by the precomputed inverse of the sample spacing.
+   * Integral values are interpolated in fixed point (Q15 / Q31 tables interpolate with the same precision as plain integers).
+   * @tparam T the type of the table values, an integer of 32 bits or less or a floating point type
+   * @tparam log2Segments the base 2 logarithm of the number of intervals between samples
+   * @tparam X the type of the input, an integer of 32 bits or less or a floating point type
+   */
+  template <typename T, size_t log2Segments, typename X = T>
+  class InterpolatingLookUpTable
+  {
+    static_assert(std::is_arithmetic_v<T>, "T must be an arithmetic type");
+    static_assert(!std::is_integral_v<T> || sizeof(T) <= 4,
+                  "Integral values are interpolated in int64_t and are limited to 32 bits");
+    static_assert(std::is_floating_point_v<X> || (std::is_integral_v<X> && sizeof(X) <= 4),
+                  "X must be a floating point type or an integer of 32 bits or less");
+    static_assert(log2Segments < 24, "Too many segments");
+
+    static constexpr size_t segments = size_t{1} << log2Segments;
+    static constexpr size_t scaleBits = 63 - log2Segments; // Fractional bits of the table position of an integral input
+    static constexpr size_t positionBits = 32;              // Fractional bits kept to interpolate
+
+    // Fractional bits used to interpolate integral values: (b - a) * fraction must fit in an int64_t
+    static constexpr size_t fractionBits = std::is_integral_v<T> ? detail::interpolation_fraction_bits<T>() : 32;
+
+    using scale_t = std::conditional_t<std::is_integral_v<X>, uint64_t, X>;
+
+  public:
+    /**
+     * @brief Constructor
+     * @param foo the function used to generate the table values, called with the sample positions
+     * (as double when X is integral, so that the samples are exactly evenly spaced)
+     * @param xmin the lower bound of the input domain
+     * @param xmax the upper bound of the input domain, strictly greater than xmin
+     */
+    template <typename Generator>
+    constexpr InterpolatingLookUpTable(Generator foo, X xmin, X xmax)
+      :
+      mXmin(xmin),
+      mXmax(xmax),
+      mScale(compute_scale(xmin, xmax))
+    {
+      for (size_t i = 0; i <= segments; ++i)
+      {
+        if constexpr (std::is_integral_v<X>)
+          mData[i] =
+            detail::to_value<T>(foo(xmin + (static_cast<double>(xmax) - xmin) * static_cast<double>(i) / segments));
+        else
+          mData[i] = detail::to_value<T>(foo(xmin + (xmax - xmin) * static_cast<X>(i) / static_cast<X>(segments)));
+      }
+      // Duplicate the last sample so that xmax needs no special case
+      mData[segments + 1] = mData[segments];
+    }
+
+    /**
+     * @brief Evaluates the sampled function
+     * @param x the input, clamped to [xmin, xmax]
+     * @return the interpolated value
+     */
+    constexpr T operator()(X x) const
+    {
+      if constexpr (std::is_integral_v<X>)
+      {
+        const X clamped = x < mXmin ? mXmin : (x > mXmax ? mXmax : x);
+        const uint64_t position = static_cast<uint64_t>(static_cast<int64_t>(clamped) - mXmin) * mScale;
+        const size_t index = position >> scaleBits;
+        const uint64_t fraction = (position >> (scaleBits - positionBits)) & ((uint64_t{1} << positionBits) - 1);
+        if constexpr (std::is_integral_v<T>)
+          return interpolate_fixed(index, static_cast<int64_t>(fraction >> (positionBits - fractionBits)));
+        else
+          return interpolate(index, static_cast<T>(fraction) * (T{1} / static_cast<T>(uint64_t{1} << positionBits)));
+      }
+      else
+      {
+        X position = (x - mXmin) * mScale;
+        position = position > X{0} ? position : X{0};
+        position = position < static_cast<X>(segments) ? position : static_cast<X>(segments);
+        const size_t index = static_cast<size_t>(position);
+        const X fraction = position - static_cast<X>(index);
+        if constexpr (std::is_integral_v<T>)
+          return interpolate_fixed(index, static_cast<int64_t>(fraction * static_cast<X>(uint64_t{1} << fractionBits)));
+        else
+          return interpolate(index, static_cast<T>(fraction));
+      }
+    }
+
+    /**
+     * @brief Array index operator
+     * @param index the index of a sample in the range [0, size()[
+     * @return a copy of the sample
+     */
+    constexpr T operator[](size_t index) const
+    {
+      return mData[index];
+    }
+
+    /**
+     * @return the number of samples
+     */
+    constexpr size_t size() const
+    {
+      return segments + 1;
+    }
+
+    /**
+     * @return the lower bound of the input domain
+     */
+    constexpr X xmin() const
+    {
+      return mXmin;
+    }
+
+    /**
+     * @return the upper bound of the input domain
+     */
+    constexpr X xmax() const
+    {
+      return mXmax;
+    }
+
+  private:
+    static constexpr scale_t compute_scale(X xmin, X xmax)
+    {
+      if constexpr (std::is_integral_v<X>)
+      {
+        // Number of segments per input unit with scaleBits fractional bits: the table position of xmax is close
+        // to 2^63 so that the multiplier keeps at least 31 significant bits. Rounding up makes the inputs that fall
+        // on a sample get a tiny positive fraction instead of the previous segment with a fraction close to 1.
+        const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(xmax) - xmin);
+        return ((uint64_t{1} << 63) + range - 1) / range;
+      }
+      else
+      {
+        return static_cast<X>(segments) / (xmax - xmin);
+      }
+    }
+
+    constexpr T interpolate(size_t index, T fraction) const
+    {
+      return mData[index] + (mData[index + 1] - mData[index]) * fraction;
+    }
+
+    constexpr T interpolate_fixed(size_t index, int64_t fraction) const
+    {
+      const int64_t a = mData[index];
+      const int64_t delta = static_cast<int64_t>(mData[index + 1]) - a;
+      return static_cast<T>(a + ((delta * fraction + (int64_t{1} << (fractionBits - 1))) >> fractionBits));
+    }
+
+    T mData[segments + 2]{};
+    X mXmin;
+    X mXmax;
+    scale_t mScale;
+  };
+} // namespace esutils
+
+#endif // ESUTILS_INTERPOLATING_LOOKUP_TABLE_HPP
@@ -0,0 +1,45 @@
+#ifndef ESUTILS_INTERPOLATION_HPP
+#define ESUTILS_INTERPOLATION_HPP
+
+/**
+ * @file interpolation.hpp
+ * Helpers shared by the interpolating lookup tables
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace esutils
+{
+  namespace detail
+  {
+    /**
+     * @brief Number of fractional bits of the fixed point fractions used to interpolate integral values of type T:
+     * the difference of two values times a fraction must fit in an int64_t
+     * @tparam T an integral type of 32 bits or less, the tables static_assert it
+     */
+    template <typename T>
+    constexpr size_t interpolation_fraction_bits()
+    {
+      constexpr int headroom = 62 - std::numeric_limits<T>::digits;
+      return headroom < 32 ? headroom : 32;
+    }
+
+    /**
+     * @brief Converts a generated or interpolated value to the type of the table values, rounding to nearest when a
+     * floating point value is converted to an integer
+     */
+    template <typename T, typename V>
+    constexpr T to_value(V v)
+    {
+      if constexpr (std::is_integral_v<T> && std::is_floating_point_v<V>)
+        return static_cast<T>(v < 0 ? v - V{0.5} : v + V{0.5});
+      else
+        return static_cast<T>(v);
+    }
+  } // namespace detail
+} // namespace esutils
+
+#endif // ESUTILS_INTERPOLATION_HPP
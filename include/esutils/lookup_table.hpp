@@ -4,10 +4,31 @@
 /**
  * @file lookup_table.hpp
  * Definition of the LookUpTable class. This class generates a lookup table at compile time.
+ * Also defines DeltaLookUpTable, a compressed variant storing each value as a short residual.
  * @author Etienne Santoul
  */
 
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "interpolation.hpp"
+#include "packed_array.hpp"
+
+#if defined(__AVX2__)
+#define ESUTILS_LOOKUP_TABLE_GATHER 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSSE3__) || (defined(__ARM_NEON) && defined(__aarch64__))
+#define ESUTILS_LOOKUP_TABLE_SHUFFLE 1
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
 
 namespace esutils
 {
@@ -22,13 +43,15 @@ namespace esutils
   public:
     /**
      * @brief Constructor
-     * @param foo the function used to generate the lookup table values by being fed successive integers in the range [0, capacity[
+     * @param foo the function used to generate the lookup table values by being fed successive integers in the range [0, capacity[.
+     * Any callable is accepted (function pointer, capturing or constexpr lambda, function object)
      */
-    constexpr LookUpTable(T(*foo)(size_t))
+    template <typename Generator>
+    constexpr LookUpTable(Generator foo)
     {
-      for (int i = 0; i < capacity; ++i)
+      for (size_t i = 0; i < capacity; ++i)
       {
-        mData[i] = foo(i);
+        mData[i] = static_cast<T>(foo(i));
       }
     }
 
@@ -48,9 +71,268 @@ namespace esutils
       return mData[index];
     }
 
+    /**
+     * @brief Looks up a whole block of indices, out[i] = (*this)[in[i]].
+     * Byte tables of up to 16 entries indexed by bytes are looked up 16 at a time with a byte shuffle (SSSE3 pshufb,
+     * AArch64 tbl). On AVX2 hosts, tables of 4 or 8 bytes values use hardware gathers of 8 or 4 values.
+     * The other cases, and the remaining elements, use the scalar lookup.
+     * @param in the indices, all in the range [0, capacity[
+     * @param out the array receiving the values
+     * @param n the number of indices
+     */
+    template <typename Index>
+    constexpr void transform(const Index *in, T *out, size_t n) const
+    {
+      static_assert(std::is_integral_v<Index>, "Index must be an integral type");
+
+      size_t i = 0;
+      if (!__builtin_is_constant_evaluated())
+      {
+#if defined(ESUTILS_LOOKUP_TABLE_SHUFFLE)
+        if constexpr (sizeof(T) == 1 && sizeof(Index) == 1 && capacity <= 16 && std::is_trivially_copyable_v<T>)
+        {
+          i = transform_shuffle(reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), n);
+        }
+#endif
+#if defined(ESUTILS_LOOKUP_TABLE_GATHER)
+        if constexpr ((sizeof(T) == 4 || sizeof(T) == 8) && sizeof(Index) <= 4 && std::is_trivially_copyable_v<T>)
+        {
+          i = transform_gather(in, out, n);
+        }
+#endif
+      }
+
+      for (; i < n; ++i)
+      {
+        out[i] = mData[static_cast<size_t>(in[i])];
+      }
+    }
+
   private:
+#if defined(ESUTILS_LOOKUP_TABLE_SHUFFLE)
+    /**
+     * @brief The 16 entries table sits in a vector register, each index byte selects a byte of it
+     * @return the number of processed indices
+     */
+    size_t transform_shuffle(const uint8_t *in, uint8_t *out, size_t n) const
+    {
+      // Copy the table first: loading 16 bytes from mData could read past its end
+      uint8_t entries[16]{};
+      for (size_t k = 0; k < capacity; ++k)
+      {
+        entries[k] = reinterpret_cast<const uint8_t *>(mData)[k];
+      }
+
+      size_t i = 0;
+#if defined(__SSSE3__)
+      const __m128i table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(entries));
+      for (; i + 16 <= n; i += 16)
+      {
+        const __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_shuffle_epi8(table, indices));
+      }
+#else
+      const uint8x16_t table = vld1q_u8(entries);
+      for (; i + 16 <= n; i += 16)
+      {
+        vst1q_u8(out + i, vqtbl1q_u8(table, vld1q_u8(in + i)));
+      }
+#endif
+      return i;
+    }
+#endif
+
+#if defined(ESUTILS_LOOKUP_TABLE_GATHER)
+    /**
+     * @return 8 indices zero extended to 32 bits
+     */
+    template <typename Index>
+    static __m256i load_indices(const Index *in)
+    {
+      if constexpr (sizeof(Index) == 1)
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(in)));
+      else if constexpr (sizeof(Index) == 2)
+        return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in)));
+      else
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+    }
+
+    /**
+     * @brief Gathers 8 values of 4 bytes or 2 x 4 values of 8 bytes per iteration
+     * @return the number of processed indices
+     */
+    template <typename Index>
+    size_t transform_gather(const Index *in, T *out, size_t n) const
+    {
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8)
+      {
+        const __m256i indices = load_indices(in + i);
+        if constexpr (sizeof(T) == 4)
+        {
+          const __m256i values = _mm256_i32gather_epi32(reinterpret_cast<const int *>(mData), indices, 4);
+          _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), values);
+        }
+        else
+        {
+          const long long *base = reinterpret_cast<const long long *>(mData);
+          const __m256i low = _mm256_i32gather_epi64(base, _mm256_castsi256_si128(indices), 8);
+          const __m256i high = _mm256_i32gather_epi64(base, _mm256_extracti128_si256(indices, 1), 8);
+          _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), low);
+          _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i + 4), high);
+        }
+      }
+      return i;
+    }
+#endif
+
     T mData[capacity]{};
   };
+
+  /**
+   * @brief A compressed lookup table of integers generated at compile time.
+   * The table is cut in segments of segmentSize values, each one approximated by a line (an anchor value and a slope).
+   * Only the difference between each value and its line, the residual, is stored on residualBits bits (offset binary)
+   * in a PackedArray. Reading a value is O(1): one multiply-shift for the line plus one packed read.
+   * Residuals that do not fit in residualBits bits are saturated and the decoded values are clamped to the range of T:
+   * max_error() gives the largest resulting error, computed at construction from the decoded values, so that the
+   * accuracy of a configuration can be checked with a static_assert.
+   * @tparam T the integral type of the values
+   * @tparam capacity the number of values in the table
+   * @tparam segmentSize the number of values sharing a line, a power of 2
+   * @tparam residualBits the number of bits of each residual
+   */
+  template <typename T, size_t capacity, size_t segmentSize = 32, size_t residualBits = 4>
+  class DeltaLookUpTable
+  {
+    static_assert(std::is_integral_v<T>, "T must be an integral type");
+    static_assert(segmentSize > 0 && (segmentSize & (segmentSize - 1)) == 0, "segmentSize must be a power of 2");
+    static_assert(residualBits > 0 && residualBits < 32, "residualBits must be in the range [1, 31]");
+
+    static constexpr size_t segmentCount = (capacity + segmentSize - 1) / segmentSize;
+    static constexpr size_t slopeBits = sizeof(T) <= 2 ? 14 : 16;
+    static constexpr int64_t residualMin = -(int64_t{1} << (residualBits - 1));
+    static constexpr int64_t residualMax = (int64_t{1} << (residualBits - 1)) - 1;
+    static constexpr int64_t valueMin = std::numeric_limits<T>::min();
+    static constexpr int64_t valueMax =
+      std::numeric_limits<T>::digits > 63 ? std::numeric_limits<int64_t>::max() : std::numeric_limits<T>::max();
+
+    using slope_t = std::conditional_t<sizeof(T) <= 2, int32_t, int64_t>;
+    // Wider than T: the anchor of a line moved to the middle of the residuals may leave the range of T
+    using anchor_t = std::conditional_t<sizeof(T) <= 2, int32_t, int64_t>;
+
+  public:
+    /**
+     * @brief Constructor
+     * @param foo the callable used to generate the values by being fed successive integers in the range [0, capacity[,
+     * floating point results are rounded to nearest
+     */
+    template <typename Generator>
+    constexpr DeltaLookUpTable(Generator foo)
+    {
+      for (size_t segment = 0; segment < segmentCount; ++segment)
+      {
+        const size_t start = segment * segmentSize;
+        const size_t length = capacity - start < segmentSize ? capacity - start : segmentSize;
+        int64_t values[segmentSize]{};
+        for (size_t k = 0; k < length; ++k)
+        {
+          values[k] = detail::to_value<int64_t>(foo(start + k));
+        }
+
+        // Chord from the first value to the first value of the next segment (or the last value of the table)
+        const int64_t end =
+          start + segmentSize < capacity ? detail::to_value<int64_t>(foo(start + segmentSize)) : values[length - 1];
+        const int64_t span = start + segmentSize < capacity ? segmentSize : (length > 1 ? length - 1 : 1);
+        const int64_t scaled = (end - values[0]) * (int64_t{1} << slopeBits);
+        const slope_t slope = static_cast<slope_t>((scaled + (scaled < 0 ? -span / 2 : span / 2)) / span);
+
+        // Move the line to the middle of the residuals so that they use both halves of the residual range
+        int64_t minResidual = 0;
+        int64_t maxResidual = 0;
+        for (size_t k = 0; k < length; ++k)
+        {
+          const int64_t residual = values[k] - line(values[0], slope, k);
+          minResidual = residual < minResidual ? residual : minResidual;
+          maxResidual = residual > maxResidual ? residual : maxResidual;
+        }
+        const anchor_t anchor = values[0] + (minResidual + maxResidual) / 2;
+        mAnchors[segment] = {anchor, slope};
+
+        for (size_t k = 0; k < length; ++k)
+        {
+          int64_t residual = values[k] - line(anchor, slope, k);
+          residual = residual < residualMin ? residualMin : (residual > residualMax ? residualMax : residual);
+          mResiduals[start + k] = static_cast<uint32_t>(residual - residualMin);
+          const int64_t error = values[k] - decode(anchor, slope, k, residual);
+          const uint64_t absError = static_cast<uint64_t>(error < 0 ? -error : error);
+          mMaxError = absError > mMaxError ? absError : mMaxError;
+        }
+      }
+    }
+
+    /**
+     * @brief Array index operator
+     * @param index the index of the lookup table value
+     * @return the decoded value
+     */
+    constexpr T operator[](size_t index) const
+    {
+      const Anchor &anchor = mAnchors[index / segmentSize];
+      const int64_t residual = static_cast<int64_t>(mResiduals[index]) + residualMin;
+      return static_cast<T>(decode(anchor.value, anchor.slope, index % segmentSize, residual));
+    }
+
+    /**
+     * @return the number of values
+     */
+    constexpr size_t size() const
+    {
+      return capacity;
+    }
+
+    /**
+     * @return the largest absolute difference between a decoded value and the generated one, 0 if the table is lossless
+     */
+    constexpr uint64_t max_error() const
+    {
+      return mMaxError;
+    }
+
+    /**
+     * @return the number of bytes used to store the values (the uncompressed table uses capacity * sizeof(T))
+     */
+    static constexpr size_t storage_size()
+    {
+      return sizeof(Anchor) * segmentCount + PackedArray<residualBits, uint32_t, capacity>::storage_size();
+    }
+
+  private:
+    struct Anchor
+    {
+      anchor_t value;
+      slope_t slope;
+    };
+
+    static constexpr int64_t line(int64_t anchor, slope_t slope, size_t k)
+    {
+      return anchor + ((static_cast<int64_t>(slope) * static_cast<int64_t>(k) + (int64_t{1} << (slopeBits - 1))) >> slopeBits);
+    }
+
+    // A saturated residual may move the value out of the range of T, it is clamped rather than wrapped by the cast
+    static constexpr int64_t decode(int64_t anchor, slope_t slope, size_t k, int64_t residual)
+    {
+      const int64_t value = line(anchor, slope, k) + residual;
+      return value < valueMin ? valueMin : (value > valueMax ? valueMax : value);
+    }
+
+    Anchor mAnchors[segmentCount]{};
+    PackedArray<residualBits, uint32_t, capacity> mResiduals{};
+    uint64_t mMaxError = 0;
+  };
 } // namespace esutils
 
+#undef ESUTILS_LOOKUP_TABLE_GATHER
+#undef ESUTILS_LOOKUP_TABLE_SHUFFLE
+
 #endif // ESUTILS_LOOKUP_TABLE_HPP
@@ -0,0 +1,295 @@
+#ifndef ESUTILS_LOOKUP_TABLE_ND_HPP
+#define ESUTILS_LOOKUP_TABLE_ND_HPP
+
+/**
+ * @file lookup_table_nd.hpp
+ * Definition of the LookUpTableND class. This class generates a multi-dimensional lookup table at compile time
+ * and evaluates it between grid points by multilinear interpolation.
+ * @author Etienne Santoul
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "interpolation.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief A multi-dimensional lookup table generated at compile time, stored in row-major order
+   * (the last index is contiguous), e.g. LookUpTableND<T, rpmCount, loadCount> for an engine map.
+   * Besides grid accesses, the table is evaluated between grid points by multilinear (bilinear in 2D,
+   * trilinear in 3D) interpolation, either with floating point coordinates or with Q16.16 fixed point ones.
+   * Coordinates are expressed in grid units and clamped to the grid.
+   * @tparam T the type of the table values
+   * @tparam sizes the number of grid points along each dimension, at least 2
+   */
+  template <typename T, size_t... sizes>
+  class LookUpTableND
+  {
+    static_assert(sizeof...(sizes) > 0, "The table needs at least one dimension");
+    static_assert(((sizes >= 2) && ...), "Every dimension needs at least two grid points to be interpolated");
+    static_assert(std::is_arithmetic_v<T>, "T must be an arithmetic type");
+
+    static constexpr size_t dims = sizeof...(sizes);
+    static constexpr size_t total = (sizes * ...);
+    static constexpr size_t corners = size_t{1} << dims;
+    static constexpr size_t fixedFractionBits = 16;
+
+    static constexpr std::array<size_t, dims> extents = {sizes...};
+
+    static constexpr std::array<size_t, dims> compute_strides()
+    {
+      std::array<size_t, dims> ret{};
+      size_t stride = 1;
+      for (size_t d = dims; d-- > 0;)
+      {
+        ret[d] = stride;
+        stride *= extents[d];
+      }
+      return ret;
+    }
+
+    static constexpr std::array<size_t, dims> strides = compute_strides();
+
+  public:
+    /**
+     * @brief Constructor
+     * @param foo the function used to generate the table values by being fed the grid indices (i, j, ...)
+     */
+    template <typename Generator>
+    constexpr LookUpTableND(Generator foo)
+    {
+      generate(foo, std::make_index_sequence<dims>{});
+    }
+
+    /**
+     * @return the number of dimensions of the table
+     */
+    static constexpr size_t rank()
+    {
+      return dims;
+    }
+
+    /**
+     * @param dim a dimension index
+     * @return the number of grid points along the dimension
+     */
+    static constexpr size_t extent(size_t dim)
+    {
+      return extents[dim];
+    }
+
+    /**
+     * @return the total number of values
+     */
+    constexpr size_t size() const
+    {
+      return total;
+    }
+
+    /**
+     * @param indices the grid indices (i, j, ...)
+     * @return a copy of the value at the grid point
+     */
+    template <typename... Indices>
+    constexpr T at(Indices... indices) const
+    {
+      static_assert(sizeof...(Indices) == dims, "One index per dimension is needed");
+      const size_t idx[dims] = {static_cast<size_t>(indices)...};
+      size_t flat = 0;
+      for (size_t d = 0; d < dims; ++d)
+      {
+        flat += idx[d] * strides[d];
+      }
+      return mData[flat];
+    }
+
+    /**
+     * @brief Evaluates the table at a point between grid points
+     * @param coords floating point coordinates in grid units, clamped to [0, extent - 1]
+     * @return the interpolated value
+     */
+    template <typename... F>
+    constexpr T interpolate(F... coords) const
+    {
+      static_assert(sizeof...(F) == dims, "One coordinate per dimension is needed");
+      static_assert((std::is_floating_point_v<F> && ...), "Use interpolate_fixed for fixed point coordinates");
+      using real_t = std::common_type_t<F...>;
+
+      const real_t c[dims] = {static_cast<real_t>(coords)...};
+      size_t base = 0;
+      real_t fraction[dims]{};
+      for (size_t d = 0; d < dims; ++d)
+      {
+        real_t x = c[d] > real_t{0} ? c[d] : real_t{0};
+        x = x < static_cast<real_t>(extents[d] - 1) ? x : static_cast<real_t>(extents[d] - 1);
+        size_t index = static_cast<size_t>(x);
+        index = index < extents[d] - 2 ? index : extents[d] - 2;
+        fraction[d] = x - static_cast<real_t>(index);
+        base += index * strides[d];
+      }
+
+      using acc_t = std::conditional_t<std::is_floating_point_v<T>, T, real_t>;
+      acc_t values[corners]{};
+      gather(base, values);
+      for (size_t d = 0, n = corners; d < dims; ++d)
+      {
+        n /= 2;
+        const acc_t f = static_cast<acc_t>(fraction[d]);
+        for (size_t k = 0; k < n; ++k)
+        {
+          values[k] = values[2 * k] + (values[2 * k + 1] - values[2 * k]) * f;
+        }
+      }
+      return detail::to_value<T>(values[0]);
+    }
+
+    /**
+     * @brief Evaluates the table at a point between grid points, using integer arithmetic only for integral tables
+     * @param coords Q16.16 fixed point coordinates in grid units, clamped to [0, extent - 1]
+     * @return the interpolated value
+     */
+    template <typename... Q>
+    constexpr T interpolate_fixed(Q... coords) const
+    {
+      static_assert(sizeof...(Q) == dims, "One coordinate per dimension is needed");
+      static_assert((std::is_integral_v<Q> && ...), "Fixed point coordinates must be integers");
+      static_assert(((sizes <= 65536) && ...), "The Q16.16 coordinates are limited to 65536 grid points per dimension");
+
+      const uint32_t c[dims] = {to_fixed_coordinate(coords)...};
+      size_t base = 0;
+      int64_t fraction[dims]{};
+      for (size_t d = 0; d < dims; ++d)
+      {
+        const uint32_t last = static_cast<uint32_t>(extents[d] - 1) << fixedFractionBits;
+        const uint32_t x = c[d] < last ? c[d] : last;
+        size_t index = x >> fixedFractionBits;
+        fraction[d] = x & ((uint32_t{1} << fixedFractionBits) - 1);
+        if (index == extents[d] - 1)
+        {
+          index = extents[d] - 2;
+          fraction[d] = int64_t{1} << fixedFractionBits;
+        }
+        base += index * strides[d];
+      }
+
+      using acc_t = std::conditional_t<std::is_floating_point_v<T>, T, int64_t>;
+      acc_t values[corners]{};
+      gather(base, values);
+      for (size_t d = 0, n = corners; d < dims; ++d)
+      {
+        n /= 2;
+        if constexpr (std::is_floating_point_v<T>)
+        {
+          const T f = static_cast<T>(fraction[d]) * (T{1} / static_cast<T>(uint32_t{1} << fixedFractionBits));
+          for (size_t k = 0; k < n; ++k)
+          {
+            values[k] = values[2 * k] + (values[2 * k + 1] - values[2 * k]) * f;
+          }
+        }
+        else
+        {
+          constexpr int64_t half = int64_t{1} << (fixedFractionBits - 1);
+          for (size_t k = 0; k < n; ++k)
+          {
+            values[k] = values[2 * k] + (((values[2 * k + 1] - values[2 * k]) * fraction[d] + half) >> fixedFractionBits);
+          }
+        }
+      }
+      return static_cast<T>(values[0]);
+    }
+
+    /**
+     * @brief Evaluates the table at n points given as structure of arrays
+     * @param coords one array of floating point coordinates per dimension, each holding n coordinates
+     * @param out the array receiving the n interpolated values
+     * @param n the number of points
+     */
+    template <typename F>
+    constexpr void interpolate_batch(const std::array<const F *, dims> &coords, T *out, size_t n) const
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        out[i] = interpolate_point(coords, i, std::make_index_sequence<dims>{});
+      }
+    }
+
+    /**
+     * @return a pointer to the values in row-major order
+     */
+    constexpr const T *data() const
+    {
+      return mData;
+    }
+
+  private:
+    /**
+     * @return the Q16.16 coordinate q converted to uint32_t, a negative coordinate becoming 0 and a too large one
+     * the maximal uint32_t
+     */
+    template <typename Q>
+    static constexpr uint32_t to_fixed_coordinate(Q q)
+    {
+      if constexpr (std::is_signed_v<Q>)
+      {
+        if (q < 0)
+          return 0;
+      }
+      const uint64_t wide = q;
+      return wide < UINT32_MAX ? wide : UINT32_MAX;
+    }
+
+    template <typename Generator, size_t... d>
+    constexpr void generate(Generator &foo, std::index_sequence<d...>)
+    {
+      for (size_t flat = 0; flat < total; ++flat)
+      {
+        mData[flat] = detail::to_value<T>(foo((flat / strides[d] % extents[d])...));
+      }
+    }
+
+    template <typename F, size_t... d>
+    constexpr T interpolate_point(const std::array<const F *, dims> &coords, size_t i, std::index_sequence<d...>) const
+    {
+      return interpolate(coords[d][i]...);
+    }
+
+    /**
+     * @brief Copies the values at the corners of the grid cell starting at base, bit d of the corner index
+     * selecting the upper grid point along dimension d
+     */
+    template <typename Acc>
+    constexpr void gather(size_t base, Acc (&values)[corners]) const
+    {
+      for (size_t corner = 0; corner < corners; ++corner)
+      {
+        size_t flat = base;
+        for (size_t d = 0; d < dims; ++d)
+        {
+          flat += ((corner >> d) & 1) * strides[d];
+        }
+        values[corner] = static_cast<Acc>(mData[flat]);
+      }
+    }
+
+    T mData[total]{};
+  };
+
+  /**
+   * @brief Two-dimensional lookup table, the value at (i, j) being stored at i * cols + j
+   */
+  template <typename T, size_t rows, size_t cols>
+  using LookUpTable2D = LookUpTableND<T, rows, cols>;
+
+  /**
+   * @brief Three-dimensional lookup table
+   */
+  template <typename T, size_t s0, size_t s1, size_t s2>
+  using LookUpTable3D = LookUpTableND<T, s0, s1, s2>;
+} // namespace esutils
+
+#endif // ESUTILS_LOOKUP_TABLE_ND_HPP
@@ -0,0 +1,291 @@
+#ifndef ESUTILS_PACKED_ARRAY_HPP
+#define ESUTILS_PACKED_ARRAY_HPP
+
+/**
+ * @file packed_array.hpp
+ * Definition of an array of integers stored on an arbitrary number of bits
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+#include "bit_pack.hpp"
+#include "bit_slice_reference.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief A fixed size array of N integers, each one stored on `bits` bits with no padding between elements.
+   * Element i occupies the bits [i * bits, (i + 1) * bits[ of the Underlying array (LSB first), which is the
+   * layout of BitSliceReference, so elements may straddle two Underlying words.
+   * @tparam bits the number of bits used to store each element
+   * @tparam T the type of the elements as seen by the user
+   * @tparam N the number of elements
+   * @tparam Underlying the unsigned integer type of the storage words
+   */
+  template <size_t bits, typename T, size_t N, typename Underlying = uint32_t>
+  class PackedArray
+  {
+    static_assert(bits > 0, "Elements must be stored on at least one bit");
+    static_assert(std::is_integral_v<T>, "T must be an integral type");
+    static_assert(std::is_unsigned_v<Underlying>, "Underlying must be an unsigned integer type");
+
+    static constexpr size_t wordBits = std::numeric_limits<Underlying>::digits;
+    static constexpr size_t wordCount = (bits * N + wordBits - 1) / wordBits;
+
+  public:
+    using reference = BitSliceReference<bits, T, Underlying>;
+    using const_reference = BitSliceReference<bits, T, const Underlying>;
+
+    /**
+     * @brief Random access iterator object.
+     * Returns a BitSliceReference when dereferenced
+     */
+    template <bool constant>
+    class Iterator
+    {
+      using underlying_t = std::conditional_t<constant, const Underlying, Underlying>;
+
+    public:
+      using iterator_category = std::random_access_iterator_tag;
+      using value_type = T;
+      using difference_type = ptrdiff_t;
+      using pointer = void;
+      using reference = BitSliceReference<bits, T, underlying_t>;
+
+      constexpr Iterator(underlying_t *data, ptrdiff_t index) : pData(data), mIndex(index) {}
+
+      /**
+       * @brief Conversion from a mutable iterator to a constant one
+       */
+      template <bool other, typename = std::enable_if_t<constant && !other>>
+      constexpr Iterator(const Iterator<other> &it) : pData(it.pData), mIndex(it.mIndex) {}
+
+      constexpr reference operator*() const { return {pData, mIndex}; }
+      constexpr reference operator[](difference_type n) const { return {pData, mIndex + n}; }
+
+      constexpr Iterator &operator++()
+      {
+        ++mIndex;
+        return *this;
+      }
+
+      constexpr Iterator operator++(int)
+      {
+        Iterator ret = *this;
+        ++mIndex;
+        return ret;
+      }
+
+      constexpr Iterator &operator--()
+      {
+        --mIndex;
+        return *this;
+      }
+
+      constexpr Iterator operator--(int)
+      {
+        Iterator ret = *this;
+        --mIndex;
+        return ret;
+      }
+
+      constexpr Iterator &operator+=(difference_type n)
+      {
+        mIndex += n;
+        return *this;
+      }
+
+      constexpr Iterator &operator-=(difference_type n)
+      {
+        mIndex -= n;
+        return *this;
+      }
+
+      constexpr Iterator operator+(difference_type n) const { return {pData, mIndex + n}; }
+      constexpr Iterator operator-(difference_type n) const { return {pData, mIndex - n}; }
+      friend constexpr Iterator operator+(difference_type n, const Iterator &it) { return it + n; }
+      constexpr difference_type operator-(const Iterator &other) const { return mIndex - other.mIndex; }
+
+      constexpr bool operator==(const Iterator &other) const { return pData == other.pData && mIndex == other.mIndex; }
+      constexpr bool operator!=(const Iterator &other) const { return !(*this == other); }
+      constexpr bool operator<(const Iterator &other) const { return mIndex < other.mIndex; }
+      constexpr bool operator>(const Iterator &other) const { return other < *this; }
+      constexpr bool operator<=(const Iterator &other) const { return !(other < *this); }
+      constexpr bool operator>=(const Iterator &other) const { return !(*this < other); }
+
+    private:
+      friend class Iterator<!constant>;
+
+      underlying_t *pData;
+      ptrdiff_t mIndex;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    /**
+     * @brief Default constructor, all elements are 0
+     */
+    constexpr PackedArray() = default;
+
+    /**
+     * @return the number of elements
+     */
+    constexpr size_t size() const
+    {
+      return N;
+    }
+
+    /**
+     * @return the number of bytes used by the packed elements
+     */
+    static constexpr size_t storage_size()
+    {
+      return sizeof(Underlying) * wordCount;
+    }
+
+    /**
+     * @brief Array subscript operator
+     * @param index the index of the desired element
+     * @return a reference to the element that can be read and written
+     */
+    constexpr reference operator[](size_t index)
+    {
+      return {mData, static_cast<ptrdiff_t>(index)};
+    }
+
+    /**
+     * @brief Array subscript operator
+     * @param index the index of the desired element
+     * @return a copy of the element
+     */
+    constexpr T operator[](size_t index) const
+    {
+      return const_reference{mData, static_cast<ptrdiff_t>(index)};
+    }
+
+    /**
+     * @brief Sets all the elements to the same value
+     * @param value the value to be written
+     */
+    constexpr void fill(T value)
+    {
+      if constexpr (wordBits % bits == 0)
+      {
+        // Elements never straddle words: build one word worth of elements and copy it
+        Underlying pattern = 0;
+        for (size_t i = 0; i < wordBits / bits; ++i)
+        {
+          reference{&pattern, static_cast<ptrdiff_t>(i)} = value;
+        }
+        for (size_t w = 0; w < wordCount; ++w)
+        {
+          mData[w] = pattern;
+        }
+      }
+      else
+      {
+        for (size_t i = 0; i < N; ++i)
+        {
+          (*this)[i] = value;
+        }
+      }
+    }
+
+    /**
+     * @brief Writes count consecutive elements from a plain array.
+     * Uses the esutils::pack kernel when the first element starts on an Underlying boundary
+     * @param src the values to be written
+     * @param count the number of elements to write
+     * @param offset the index of the first element to write
+     */
+    constexpr void copy_from(const T *src, size_t count, size_t offset = 0)
+    {
+      if ((offset * bits) % wordBits == 0)
+      {
+        pack<bits>(src, count, mData + offset * bits / wordBits);
+        return;
+      }
+      for (size_t i = 0; i < count; ++i)
+      {
+        (*this)[offset + i] = src[i];
+      }
+    }
+
+    /**
+     * @brief Reads count consecutive elements to a plain array.
+     * Uses the esutils::unpack kernel when the first element starts on an Underlying boundary
+     * @param dst the array receiving the values
+     * @param count the number of elements to read
+     * @param offset the index of the first element to read
+     */
+    constexpr void copy_to(T *dst, size_t count, size_t offset = 0) const
+    {
+      if ((offset * bits) % wordBits == 0)
+      {
+        unpack<bits>(mData + offset * bits / wordBits, count, dst);
+        return;
+      }
+      for (size_t i = 0; i < count; ++i)
+      {
+        dst[i] = (*this)[offset + i];
+      }
+    }
+
+    /**
+     * @return a pointer to the packed storage
+     */
+    constexpr Underlying *data()
+    {
+      return mData;
+    }
+
+    /**
+     * @return a pointer to the packed storage
+     */
+    constexpr const Underlying *data() const
+    {
+      return mData;
+    }
+
+    constexpr iterator begin()
+    {
+      return {mData, 0};
+    }
+
+    constexpr iterator end()
+    {
+      return {mData, static_cast<ptrdiff_t>(N)};
+    }
+
+    constexpr const_iterator begin() const
+    {
+      return {mData, 0};
+    }
+
+    constexpr const_iterator end() const
+    {
+      return {mData, static_cast<ptrdiff_t>(N)};
+    }
+
+    constexpr const_iterator cbegin() const
+    {
+      return {mData, 0};
+    }
+
+    constexpr const_iterator cend() const
+    {
+      return {mData, static_cast<ptrdiff_t>(N)};
+    }
+
+  private:
+    Underlying mData[wordCount]{};
+  };
+} // namespace esutils
+
+#endif // ESUTILS_PACKED_ARRAY_HPP
@@ -0,0 +1,174 @@
+#ifndef ESUTILS_RANK_SELECT_INDEX_HPP
+#define ESUTILS_RANK_SELECT_INDEX_HPP
+
+/**
+ * @file rank_select_index.hpp
+ * Definition of a succinct rank / select acceleration structure over a BoolCollection
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bit_operations.hpp"
+#include "bool_collection.hpp"
+#include "type_capacity.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief Answers "how many bits are set before index i" (rank) and "where is the k-th set bit" (select)
+   * over a BoolCollection without walking it.
+   * Set bits are counted per superblock of 512 bits (absolute counts) and per block of 64 bits (counts relative
+   * to the superblock), so rank is two table reads and a popcount. The superblock of every
+   * selectSampleRate-th set bit is sampled so that select only scans a few superblocks.
+   * The index keeps a pointer to the collection: it must be updated (rebuild() or update()) after the collection is modified.
+   * @tparam sz the size of the indexed BoolCollection
+   * @tparam selectSampleRate the number of set bits between two select samples
+   */
+  template <size_t sz, size_t selectSampleRate = 256>
+  class RankSelectIndex
+  {
+    static_assert(sz > 0, "The indexed BoolCollection must not be empty");
+    static_assert(selectSampleRate > 0, "selectSampleRate must be strictly positive");
+
+    static constexpr size_t blockBits = 64;
+    static constexpr size_t blocksPerSuperblock = 8;
+    static constexpr size_t superblockBits = blockBits * blocksPerSuperblock;
+    static constexpr size_t blockCount = (sz + blockBits - 1) / blockBits;
+    static constexpr size_t superblockCount = (sz + superblockBits - 1) / superblockBits;
+    static constexpr size_t sampleCount = sz / selectSampleRate + 1;
+
+    using rank_t = typename TypeCapacity<sz>::type;
+    using superblock_t = typename TypeCapacity<superblockCount>::type;
+
+  public:
+    /**
+     * @brief Constructor, builds the index
+     * @param collection the indexed BoolCollection, must outlive the index
+     */
+    constexpr RankSelectIndex(const BoolCollection<sz> &collection)
+      :
+      pCollection(&collection)
+    {
+      rebuild();
+    }
+
+    /**
+     * @brief Recomputes the whole index
+     */
+    constexpr void rebuild()
+    {
+      update(0);
+    }
+
+    /**
+     * @brief Recomputes the index after bits at or after index have been modified
+     * @param index the lowest modified bit index
+     */
+    constexpr void update(size_t index)
+    {
+      size_t superblock = (index < sz ? index : sz - 1) / superblockBits;
+      size_t count = superblock == 0 ? 0 : mSuperblockRank[superblock];
+      for (; superblock < superblockCount; ++superblock)
+      {
+        mSuperblockRank[superblock] = count;
+        size_t relative = 0;
+        for (size_t b = superblock * blocksPerSuperblock; b < blockCount && b < (superblock + 1) * blocksPerSuperblock; ++b)
+        {
+          mBlockRank[b] = static_cast<uint16_t>(relative);
+          relative += popcount(block_word(b));
+        }
+        count += relative;
+      }
+      mCount = count;
+
+      // Select samples are cheap to recompute from the superblock counts
+      size_t sample = 0;
+      for (superblock = 0; superblock < superblockCount; ++superblock)
+      {
+        const size_t end = superblock + 1 < superblockCount ? mSuperblockRank[superblock + 1] : mCount;
+        while (sample * selectSampleRate < end)
+          mSelectSample[sample++] = superblock;
+      }
+    }
+
+    /**
+     * @return the number of set bits in the collection
+     */
+    constexpr size_t count() const
+    {
+      return mCount;
+    }
+
+    /**
+     * @param index a bit index in the range [0, sz]
+     * @return the number of set bits in the range [0, index[
+     */
+    constexpr size_t rank(size_t index) const
+    {
+      if (index >= sz)
+        return mCount;
+      const size_t block = index / blockBits;
+      const size_t bitInBlock = index % blockBits;
+      size_t ret = mSuperblockRank[block / blocksPerSuperblock] + mBlockRank[block];
+      if (bitInBlock)
+        ret += popcount(block_word(block) >> (blockBits - bitInBlock));
+      return ret;
+    }
+
+    /**
+     * @param k the rank of the wanted set bit (0 for the first one)
+     * @return the index of the k-th set bit or sz if there are not that many set bits
+     */
+    constexpr size_t select(size_t k) const
+    {
+      if (k >= mCount)
+        return sz;
+
+      size_t superblock = mSelectSample[k / selectSampleRate];
+      while (superblock + 1 < superblockCount && mSuperblockRank[superblock + 1] <= k)
+        ++superblock;
+      k -= mSuperblockRank[superblock];
+
+      size_t block = superblock * blocksPerSuperblock;
+      while (block + 1 < blockCount && block + 1 < (superblock + 1) * blocksPerSuperblock && mBlockRank[block + 1] <= k)
+        ++block;
+      k -= mBlockRank[block];
+
+      // Drop the k highest set bits, the wanted bit is then the highest remaining one
+      uint64_t word = block_word(block);
+      for (; k > 0; --k)
+        word &= ~(uint64_t{1} << (blockBits - 1 - countl_zero(word)));
+      return block * blockBits + countl_zero(word);
+    }
+
+  private:
+    /**
+     * @return the 64 bits of a block, bit i of the block being the bit 63 - i of the word
+     */
+    constexpr uint64_t block_word(size_t block) const
+    {
+      const uint8_t *bytes = pCollection->data();
+      uint64_t word = 0;
+      for (size_t i = 0; i < blockBits / 8; ++i)
+      {
+        const size_t byte = block * (blockBits / 8) + i;
+        word = (word << 8) | (byte < (sz + 7) / 8 ? bytes[byte] : 0);
+      }
+      // Ignore the padding bits after the last element
+      const size_t validBits = sz - block * blockBits;
+      if (validBits < blockBits)
+        word &= ~(~uint64_t{0} >> validBits);
+      return word;
+    }
+
+    const BoolCollection<sz> *pCollection;
+    rank_t mSuperblockRank[superblockCount]{};
+    uint16_t mBlockRank[blockCount]{};
+    superblock_t mSelectSample[sampleCount]{};
+    rank_t mCount = 0;
+  };
+} // namespace esutils
+
+#endif // ESUTILS_RANK_SELECT_INDEX_HPP
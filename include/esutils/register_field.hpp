@@ -0,0 +1,234 @@
+#ifndef ESUTILS_REGISTER_FIELD_HPP
+#define ESUTILS_REGISTER_FIELD_HPP
+
+/**
+ * @file register_field.hpp
+ * Compile time description of peripheral registers and fields, with field writes batched in a single register access
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "bit_slice_reference.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief The bits of one or several fields of a register, to be written in a single access
+   * @tparam T the unsigned integer type of the register
+   */
+  template <typename T>
+  struct FieldValue
+  {
+    T mask;  // Bits of the register that are written
+    T value; // Values of these bits
+
+    /**
+     * @brief Combines the values of several fields, the fields must not overlap
+     */
+    constexpr FieldValue operator|(const FieldValue &other) const
+    {
+      return {static_cast<T>(mask | other.mask), static_cast<T>(value | other.value)};
+    }
+  };
+
+  /**
+   * @brief Description of a field of bitWidth bits at bit bitOffset of a register of type T
+   * @tparam bitOffset the position of the least significant bit of the field
+   * @tparam bitWidth the number of bits of the field
+   * @tparam T the unsigned integer type of the register
+   */
+  template <size_t bitOffset, size_t bitWidth, typename T = uint32_t>
+  struct RegisterField
+  {
+    static_assert(std::is_unsigned_v<T>, "T must be an unsigned integer type");
+
+    using register_type = T;
+    using reference = BitFieldReference<bitOffset, bitWidth, T, volatile T>;
+
+    static constexpr size_t offset = bitOffset;
+    static constexpr size_t width = bitWidth;
+    static constexpr T mask = reference::mask;
+
+    /**
+     * @param v the value of the field, extra high bits are discarded
+     * @return the register bits corresponding to the field set to v
+     */
+    static constexpr FieldValue<T> value(T v)
+    {
+      return {mask, static_cast<T>((v << bitOffset) & mask)};
+    }
+
+    /**
+     * @brief Field value known at compile time, checked to fit in the field
+     */
+    template <T v>
+    static constexpr FieldValue<T> constant()
+    {
+      static_assert((v >> (bitWidth - 1) >> 1) == 0, "The value does not fit in the field");
+      return value(v);
+    }
+
+    /**
+     * @brief The field with all its bits set (mostly useful for single bit fields)
+     */
+    static constexpr FieldValue<T> set = {mask, mask};
+
+    /**
+     * @brief The field with all its bits cleared
+     */
+    static constexpr FieldValue<T> cleared = {mask, 0};
+
+    /**
+     * @param registerValue a value read from the register
+     * @return the value of the field in registerValue
+     */
+    static constexpr T extract(T registerValue)
+    {
+      return static_cast<T>((registerValue & mask) >> bitOffset);
+    }
+  };
+
+  /**
+   * @brief Register access with plain volatile loads and stores.
+   * A modification is a single load followed by a single store, which is not atomic with respect to interrupts.
+   */
+  struct VolatileAccess
+  {
+    template <typename T>
+    static T load(const volatile T *reg)
+    {
+      return *reg;
+    }
+
+    template <typename T>
+    static void store(volatile T *reg, T value)
+    {
+      *reg = value;
+    }
+
+    template <typename T>
+    static void modify(volatile T *reg, T clearMask, T setBits)
+    {
+      const T current = *reg;
+      *reg = static_cast<T>((current & ~clearMask) | setBits);
+    }
+  };
+
+  /**
+   * @brief Register access with atomic operations.
+   * A modification is a compare and swap loop (LDREX/STREX on Cortex-M3 and above), so it can not be torn
+   * by an interrupt or another thread modifying other fields of the same register.
+   */
+  struct AtomicAccess
+  {
+    template <typename T>
+    static T load(const volatile T *reg)
+    {
+      return __atomic_load_n(reg, __ATOMIC_SEQ_CST);
+    }
+
+    template <typename T>
+    static void store(volatile T *reg, T value)
+    {
+      __atomic_store_n(reg, value, __ATOMIC_SEQ_CST);
+    }
+
+    template <typename T>
+    static void modify(volatile T *reg, T clearMask, T setBits)
+    {
+      T expected = __atomic_load_n(reg, __ATOMIC_RELAXED);
+      T desired;
+      do
+      {
+        desired = static_cast<T>((expected & ~clearMask) | setBits);
+      } while (!__atomic_compare_exchange_n(reg, &expected, desired, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+    }
+  };
+
+  /**
+   * @brief A register at a fixed address whose fields are described by RegisterField types.
+   * Writing several fields through modify() or write() performs a single register access whatever the number of fields:
+   * the combined mask and value are computed at compile time when the field values are constants.
+   * @tparam T the unsigned integer type of the register
+   * @tparam Access the access policy (VolatileAccess or AtomicAccess)
+   */
+  template <typename T, typename Access = VolatileAccess>
+  class Register
+  {
+    static_assert(std::is_unsigned_v<T>, "T must be an unsigned integer type");
+
+  public:
+    /**
+     * @brief Constructor
+     * @param address the address of the register
+     */
+    constexpr Register(volatile T *address) : pReg(address) {}
+
+    /**
+     * @return the raw value of the register
+     */
+    T read() const
+    {
+      return Access::load(pReg);
+    }
+
+    /**
+     * @tparam Field the RegisterField to read
+     * @return the value of the field
+     */
+    template <typename Field>
+    T read() const
+    {
+      static_assert(std::is_same_v<typename Field::register_type, T>, "Field belongs to a register of another type");
+      return Field::extract(read());
+    }
+
+    /**
+     * @brief Writes the raw value of the register
+     */
+    void write(T value)
+    {
+      Access::store(pReg, value);
+    }
+
+    /**
+     * @brief Writes the register in a single store (no read), the bits outside of the given fields are written to 0
+     * @param values the field values, e.g. Mode::value(3), Enable::set
+     */
+    template <typename... Values>
+    void write(const FieldValue<T> &first, const Values &...others)
+    {
+      Access::store(pReg, (first | ... | others).value);
+    }
+
+    /**
+     * @brief Updates several fields in a single read-modify-write, the other bits of the register are preserved
+     * @param values the field values, e.g. Mode::value(3), Enable::set
+     */
+    template <typename... Values>
+    void modify(const FieldValue<T> &first, const Values &...others)
+    {
+      const FieldValue<T> combined = (first | ... | others);
+      Access::modify(pReg, combined.mask, combined.value);
+    }
+
+    /**
+     * @tparam Field the RegisterField to access
+     * @return a reference allowing to read or write a single field (one read-modify-write per write)
+     */
+    template <typename Field>
+    typename Field::reference field()
+    {
+      static_assert(std::is_same_v<typename Field::register_type, T>, "Field belongs to a register of another type");
+      return {pReg};
+    }
+
+  private:
+    volatile T *pReg;
+  };
+} // namespace esutils
+
+#endif // ESUTILS_REGISTER_FIELD_HPP
@@ -7,10 +7,10 @@
  * @author Etienne Santoul
  */
 
-#include <algorithm>
 #include <cstddef>
 #include <optional>
 
+#include "instrumentation.hpp"
 #include "type_capacity.hpp"
 
 namespace esutils
@@ -30,10 +30,11 @@ namespace esutils
    * @brief A contiguous chunk of data that is cycled through
    * @tparam T the type that is being contained
    * @tparam cty the maximum number of elements that can be contained
+   * @tparam Instrumentation the policy recording the use of the RingBuffer, see instrumentation.hpp
    * @todo Check whether a destructor should be called on clear
    */
-  template <typename T, size_t cty>
-  class RingBuffer
+  template <typename T, size_t cty, typename Instrumentation = NoInstrumentation>
+  class RingBuffer : private Instrumentation
   {
   public:
     constexpr RingBuffer() = default;
@@ -41,45 +42,47 @@ namespace esutils
     /**
      * @brief Resets the RingBuffer
      */
-    void clear()
+    constexpr void clear()
     {
       mReadPos = mWritePos = 0;
+      mReadable = 0;
     }
 
     /**
      * @return The maximal number of elements that can be contained in the RingBuffer
      */
-    size_t capacity() const { return cty; }
+    constexpr size_t capacity() const { return cty; }
 
     /**
      * @return The number of elements that can be read from the RingBuffer
      */
-    size_t readable() const
+    constexpr size_t readable() const
     {
-      if (mWritePos >= mReadPos)
-        return mWritePos - mReadPos;
-      else
-        return mWritePos + cty - mReadPos;
+      return mReadable;
     }
 
     /**
      * @return The number of elements that can be written in the RingBuffer before it is full
      */
-    size_t writable() const { return cty - readable(); }
+    constexpr size_t writable() const { return cty - readable(); }
 
     /**
      * @brief Adds a single element to the RingBuffer
      * @param val The value to be written
      * @return True if the element was added, else if the RingBuffer is already full
      */
-    bool write(const T &val)
+    constexpr bool write(const T &val)
     {
-      if (writable())
+      const auto start = Instrumentation::start();
+      const bool written = writable() != 0;
+      if (written)
       {
         mData[mWritePos++] = val;
-        return true;
+        ++mReadable;
       }
-      return false;
+      Instrumentation::count(written ? ContainerEvent::INSERTED : ContainerEvent::REJECTED);
+      Instrumentation::finish(mReadable, start);
+      return written;
     }
 
     /**
@@ -87,39 +90,48 @@ namespace esutils
      * @return A std::optional containing the first readable value if there
      * is some value to read or nothing if there a no elements to read
      */
-    std::optional<T> read()
+    constexpr std::optional<T> read()
     {
-      if (readable())
+      const auto start = Instrumentation::start();
+      const bool consumed = readable() != 0;
+      // Constructed at once: the assignment of a std::optional is not constexpr before C++20
+      const std::optional<T> val = consumed ? std::optional<T>(mData[mReadPos++]) : std::nullopt;
+      if (consumed)
       {
-        return {mData[mReadPos++]};
+        --mReadable;
+        Instrumentation::count(ContainerEvent::REMOVED);
       }
-      return {};
+      Instrumentation::finish(mReadable, start);
+      return val;
     }
 
     /**
      * @brief Reads multiple elements of the RingBuffer. If elements are read, they are consumed from the RingBuffer.
      * @param size The number of elements to read
-     * @return A pointer to the first element of the array of read elements if the read was successful or nullptr if the read failed
+     * @return A pointer to the first element of the array of read elements if the read was successful or nullptr if the read failed.
+     * The elements stay valid until the next write
      * @todo Maybe make a version that returns a custom iterator that avoids rotation of mData
      */
-    T *read(size_t size)
+    constexpr T *read(size_t size)
     {
+      const auto start = Instrumentation::start();
+      T *data = nullptr;
       if (size <= readable())
       {
-        if (cty - mReadPos > size) // Need to rotate mData in order to have a contiguous chunk of retured data
+        if (cty - mReadPos < size) // Need to rotate mData in order to have a contiguous chunk of retured data
         {
-          std::rotate(mData, mData + mReadPos, mData + cty);
-          mWritePos = mReadPos > mWritePos ? mWritePos + cty - mReadPos : mWritePos - mReadPos;
+          rotate(mReadPos);
           mReadPos = 0;
-          return mData;
-        }
-        else
-        {
-          return mData + mReadPos;
+          mWritePos = mReadable == cty ? 0 : mReadable;
         }
+        data = mData + mReadPos;
+        mReadPos.advance(size);
+        mReadable -= size;
+        Instrumentation::count(ContainerEvent::REMOVED, size);
       }
-      // Cannot read that much data
-      return nullptr;
+      // Else cannot read that much data
+      Instrumentation::finish(mReadable, start);
+      return data;
     }
 
     /**
@@ -127,19 +139,25 @@ namespace esutils
      * @param val The value to be written
      * @return A esutils::RINGBUFFER_STATUS status code
      */
-    uint8_t overwrite(const T &val)
+    constexpr uint8_t overwrite(const T &val)
     {
-      if (mWritePos == mReadPos) // Overwriting
+      const auto start = Instrumentation::start();
+      uint8_t status = RINGBUFFER_STATUS::OK; // No data has been overwritten
+      if (!writable()) // Overwriting
       {
         mData[mWritePos++] = val;
         mReadPos = mWritePos;
-        return RINGBUFFER_STATUS::DATA_OVERWRITTEN; // Some data has been overwritten
+        Instrumentation::count(ContainerEvent::OVERWRITTEN);
+        status = RINGBUFFER_STATUS::DATA_OVERWRITTEN; // Some data has been overwritten
       }
       else // Simply writing
       {
         mData[mWritePos++] = val;
-        return RINGBUFFER_STATUS::OK; // No data has been overwritten
+        ++mReadable;
       }
+      Instrumentation::count(ContainerEvent::INSERTED);
+      Instrumentation::finish(mReadable, start);
+      return status;
     }
 
     /**
@@ -149,37 +167,106 @@ namespace esutils
      * @param length The number of elements to be added to the RingBuffer
      * @return A esutils::RINGBUFFER_STATUS status code
      */
-    uint8_t overwrite(const T *array, size_t length)
+    constexpr uint8_t overwrite(const T *array, size_t length)
     {
+      const auto start = Instrumentation::start();
+      uint8_t status = RINGBUFFER_STATUS::OK;
       if (length > cty)
       {
-        return RINGBUFFER_STATUS::NO_DATA_WRITTEN | RINGBUFFER_STATUS::NOT_ENOUGH_SPACE
+        Instrumentation::count(ContainerEvent::REJECTED, length);
+        status = RINGBUFFER_STATUS::NO_DATA_WRITTEN | RINGBUFFER_STATUS::NOT_ENOUGH_SPACE;
       }
       else if (length > writable())
       {
+        Instrumentation::count(ContainerEvent::OVERWRITTEN, length - writable());
+        Instrumentation::count(ContainerEvent::INSERTED, length);
         for (size_t i = 0; i < length; ++i)
           mData[mWritePos++] = array[i];
         mReadPos = mWritePos;
-        return RINGBUFFER_STATUS::DATA_OVERWRITTEN;
+        mReadable = cty;
+        status = RINGBUFFER_STATUS::DATA_OVERWRITTEN;
       }
       else
       {
+        Instrumentation::count(ContainerEvent::INSERTED, length);
         for (size_t i = 0; i < length; ++i)
           mData[mWritePos++] = array[i];
-        return RINGBUFFER_STATUS::OK;
+        mReadable += length;
       }
+      Instrumentation::finish(mReadable, start);
+      return status;
     }
 
     /**
      * @brief A function to take a look or modify inplace the value of the first readable element
      * @return A pointer to the first readable element if there is one or nullptr
      */
-    T *peek()
+    constexpr T *peek()
+    {
+      return readable() ? mData + mReadPos : nullptr;
+    }
+
+    /**
+     * @brief A function to take a look at the value of the first readable element
+     * @return A pointer to the first readable element if there is one or nullptr
+     */
+    constexpr const T *peek() const
     {
       return readable() ? mData + mReadPos : nullptr;
     }
 
+    /**
+     * @brief Accesses a readable element without consuming it
+     * @param i the rank of the element in the range [0, readable()[, 0 being the next element to read
+     * @return a reference to the element
+     */
+    constexpr const T &operator[](size_t i) const
+    {
+      const size_t pos = mReadPos + i;
+      return mData[pos >= cty ? pos - cty : pos];
+    }
+
+    /**
+     * @return the capacity, the number of readable elements and the statistics recorded by the instrumentation policy
+     */
+    constexpr ContainerSnapshot snapshot() const
+    {
+      return Instrumentation::snapshot(cty, readable());
+    }
+
+    /**
+     * @return the instrumentation policy, e.g. to reset its statistics
+     */
+    constexpr Instrumentation &instrumentation()
+    {
+      return *this;
+    }
+
   private:
+    /**
+     * @brief Rotates mData to the left so that mData[first] becomes mData[0], with three reversals since std::rotate is
+     * not constexpr before C++20
+     */
+    constexpr void rotate(size_t first)
+    {
+      reverse(0, first);
+      reverse(first, cty);
+      reverse(0, cty);
+    }
+
+    /**
+     * @brief Reverses mData in the range [first, last[
+     */
+    constexpr void reverse(size_t first, size_t last)
+    {
+      while (first + 1 < last)
+      {
+        const T tmp = mData[first];
+        mData[first++] = mData[--last];
+        mData[last] = tmp;
+      }
+    }
+
     /**
      * @brief A forward index that goes back to 0 when reaching cty
      */
@@ -190,11 +277,11 @@ namespace esutils
       cty_t mIdx = 0;
 
     public:
-      cty_t operator=(cty_t val) { return mIdx = val; }
+      constexpr cty_t operator=(cty_t val) { return mIdx = val; }
 
-      operator size_t() const { return mIdx; }
+      constexpr operator size_t() const { return mIdx; }
 
-      size_t operator++(int)
+      constexpr size_t operator++(int)
       {
         size_t val = mIdx;
         if (++mIdx >= cty)
@@ -202,15 +289,21 @@ namespace esutils
         return val;
       }
 
-      size_t operator++()
+      constexpr size_t operator++()
       {
         (*this)++;
         return *this;
       }
+
+      constexpr void advance(size_t n)
+      {
+        mIdx = (mIdx + n) % cty;
+      }
     };
 
     T mData[cty]{};
     CyclicIndex mReadPos, mWritePos;
+    typename TypeCapacity<cty>::type mReadable = 0;
   };
 } // namespace esutils
 
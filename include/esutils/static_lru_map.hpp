@@ -0,0 +1,304 @@
+#ifndef ESUTILS_STATIC_LRU_MAP_HPP
+#define ESUTILS_STATIC_LRU_MAP_HPP
+
+/**
+ * @file static_lru_map.hpp
+ * Definition of a least recently used cache with a capacity fixed at compile time
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "type_capacity.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief A map of at most cty entries that evicts the least recently used entry when a new one is put in a full map.
+   * The entries live in fixed arrays and are linked by index three ways: in the chain of their hash bucket, in the
+   * recency list (most recently used first) and, once erased, in the list of free entries. get, put and erase are
+   * O(1) on average and never allocate.
+   * @tparam K the type of the keys
+   * @tparam V the type of the values
+   * @tparam cty the maximal number of entries
+   * @tparam Hash the hash function of the keys, its result is mixed again so the identity is fine
+   */
+  template <typename K, typename V, size_t cty, typename Hash = std::hash<K>>
+  class StaticLruMap
+  {
+    static_assert(cty > 0, "The capacity must be at least 1");
+
+    using cty_t = typename TypeCapacity<cty>::type;
+
+  public:
+    StaticLruMap()
+    {
+      clear();
+    }
+
+    /**
+     * @return the maximal number of entries
+     */
+    size_t capacity() const
+    {
+      return cty;
+    }
+
+    /**
+     * @return the current number of entries
+     */
+    size_t size() const
+    {
+      return mSize;
+    }
+
+    /**
+     * @brief Looks up a key and makes its entry the most recently used one. The lookup is counted as a hit or a miss
+     * @param key the key to be found
+     * @return a pointer to the value of the key, or nullptr if it is not in the map
+     */
+    V *get(const K &key)
+    {
+      const cty_t i = find(key);
+      if (i == nil)
+      {
+        ++mMisses;
+        return nullptr;
+      }
+      ++mHits;
+      touch(i);
+      return &mEntries[i].value;
+    }
+
+    /**
+     * @brief Looks up a key without changing the recency order nor the counters
+     * @param key the key to be found
+     * @return a pointer to the value of the key, or nullptr if it is not in the map
+     */
+    const V *peek(const K &key) const
+    {
+      const cty_t i = find(key);
+      return i != nil ? &mEntries[i].value : nullptr;
+    }
+
+    /**
+     * @param key the key to be found
+     * @return true if the key is in the map
+     */
+    bool contains(const K &key) const
+    {
+      return find(key) != nil;
+    }
+
+    /**
+     * @brief Inserts or assigns the value of a key and makes its entry the most recently used one.
+     * If the key is new and the map is full, the least recently used entry is evicted
+     * @param key the key of the entry
+     * @param value the value of the entry
+     * @return true if the key was inserted else false (its value was assigned)
+     */
+    bool put(const K &key, const V &value)
+    {
+      cty_t i = find(key);
+      if (i != nil)
+      {
+        mEntries[i].value = value;
+        touch(i);
+        return false;
+      }
+
+      if (mFree == nil)
+      {
+        i = mTail;
+        unlink_recency(i);
+        unlink_bucket(i);
+        ++mEvictions;
+      }
+      else
+      {
+        i = mFree;
+        mFree = mEntries[i].chain;
+        ++mSize;
+      }
+
+      Entry &entry = mEntries[i];
+      entry.key = key;
+      entry.value = value;
+      cty_t &bucket = mBuckets[bucket_of(key)];
+      entry.chain = bucket;
+      bucket = i;
+      link_front(i);
+      return true;
+    }
+
+    /**
+     * @brief Removes the entry of a key
+     * @param key the key of the entry
+     * @return true if the entry was removed else false (the key was not in the map)
+     */
+    bool erase(const K &key)
+    {
+      const cty_t i = find(key);
+      if (i == nil)
+        return false;
+      unlink_recency(i);
+      unlink_bucket(i);
+      mEntries[i].chain = mFree;
+      mFree = i;
+      --mSize;
+      return true;
+    }
+
+    /**
+     * @return a pointer to the key of the least recently used entry, which is the next to be evicted, or nullptr if
+     * the map is empty
+     */
+    const K *least_recent() const
+    {
+      return mTail != nil ? &mEntries[mTail].key : nullptr;
+    }
+
+    /**
+     * @brief Removes all the entries, the counters are kept
+     */
+    void clear()
+    {
+      for (auto &bucket : mBuckets)
+        bucket = nil;
+      for (size_t i = 0; i < cty; ++i)
+        mEntries[i].chain = i + 1;
+      mFree = 0;
+      mHead = mTail = nil;
+      mSize = 0;
+    }
+
+    /**
+     * @return the number of get calls that found their key
+     */
+    uint32_t hits() const
+    {
+      return mHits;
+    }
+
+    /**
+     * @return the number of get calls that did not find their key
+     */
+    uint32_t misses() const
+    {
+      return mMisses;
+    }
+
+    /**
+     * @return the number of entries evicted by put
+     */
+    uint32_t evictions() const
+    {
+      return mEvictions;
+    }
+
+    /**
+     * @brief Resets the hit, miss and eviction counters
+     */
+    void reset_statistics()
+    {
+      mHits = mMisses = mEvictions = 0;
+    }
+
+  private:
+    struct Entry
+    {
+      K key{};
+      V value{};
+      cty_t chain = nil; // Next entry of the bucket, or next free entry
+      cty_t prev = nil;  // More recently used entry
+      cty_t next = nil;  // Less recently used entry
+    };
+
+    static constexpr cty_t nil = cty;
+
+    static constexpr size_t bucket_bits()
+    {
+      size_t bits = 0;
+      while ((size_t{1} << bits) < cty)
+        ++bits;
+      return bits;
+    }
+
+    // At least as many buckets as entries so that the chains stay short
+    static constexpr size_t bucketBits = bucket_bits();
+    static constexpr size_t buckets = size_t{1} << bucketBits;
+
+    // Fibonacci hashing: the top bits of the product depend on all the bits of the hash
+    static size_t bucket_of(const K &key)
+    {
+      if constexpr (bucketBits == 0)
+        return 0;
+      else
+        return (uint64_t{Hash{}(key)} * 0x9E3779B97F4A7C15u) >> (64 - bucketBits);
+    }
+
+    cty_t find(const K &key) const
+    {
+      cty_t i = mBuckets[bucket_of(key)];
+      while (i != nil && !(mEntries[i].key == key))
+        i = mEntries[i].chain;
+      return i;
+    }
+
+    void unlink_bucket(cty_t i)
+    {
+      cty_t *link = &mBuckets[bucket_of(mEntries[i].key)];
+      while (*link != i)
+        link = &mEntries[*link].chain;
+      *link = mEntries[i].chain;
+    }
+
+    void link_front(cty_t i)
+    {
+      Entry &entry = mEntries[i];
+      entry.prev = nil;
+      entry.next = mHead;
+      if (mHead != nil)
+        mEntries[mHead].prev = i;
+      else
+        mTail = i;
+      mHead = i;
+    }
+
+    void unlink_recency(cty_t i)
+    {
+      Entry &entry = mEntries[i];
+      if (entry.prev != nil)
+        mEntries[entry.prev].next = entry.next;
+      else
+        mHead = entry.next;
+      if (entry.next != nil)
+        mEntries[entry.next].prev = entry.prev;
+      else
+        mTail = entry.prev;
+    }
+
+    void touch(cty_t i)
+    {
+      if (i != mHead)
+      {
+        unlink_recency(i);
+        link_front(i);
+      }
+    }
+
+    Entry mEntries[cty]{};
+    cty_t mBuckets[buckets]{};
+    cty_t mHead = nil;
+    cty_t mTail = nil;
+    cty_t mFree = nil;
+    cty_t mSize = 0;
+    uint32_t mHits = 0;
+    uint32_t mMisses = 0;
+    uint32_t mEvictions = 0;
+  };
+} // namespace esutils
+
+#endif // ESUTILS_STATIC_LRU_MAP_HPP
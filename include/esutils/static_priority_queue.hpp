@@ -0,0 +1,262 @@
+#ifndef ESUTILS_STATIC_PRIORITY_QUEUE_HPP
+#define ESUTILS_STATIC_PRIORITY_QUEUE_HPP
+
+/**
+ * @file static_priority_queue.hpp
+ * Definition of a priority queue with a capacity fixed at compile time and stable handles to its elements
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+
+#include "handle_pool.hpp"
+#include "type_capacity.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief A priority queue stored in a 4-ary heap: the 4 children of a node are contiguous so a level of the sift down
+   * reads a single cache line for small T, and the heap is half as deep as a binary one.
+   * Every element gets a handle when it is pushed, which stays valid until the element leaves the queue: it is used to
+   * update the priority of an element or to erase it in O(log n). Handles carry a generation (see HandlePool), so the
+   * handle of an element that left the queue is rejected rather than designating the element reusing its slot.
+   * @tparam T the type of the elements
+   * @tparam cty the maximal number of elements
+   * @tparam Compare like std::priority_queue, the top element is the largest for Compare: std::less<T> (the default)
+   * gives a max-heap and std::greater<T> a min-heap, which is what deadlines need
+   */
+  template <typename T, size_t cty, typename Compare = std::less<T>>
+  class StaticPriorityQueue
+  {
+    static_assert(cty > 0, "The capacity must be at least 1");
+
+    using cty_t = typename TypeCapacity<cty>::type;
+    using handles_t = HandlePool<cty>;
+
+  public:
+    /**
+     * @brief The type of the handles
+     */
+    using handle_t = typename handles_t::handle_t;
+
+    /**
+     * @brief The handle returned when an element cannot be pushed
+     */
+    static constexpr handle_t INVALID_HANDLE = handles_t::INVALID_HANDLE;
+
+    StaticPriorityQueue()
+    {
+      for (auto &position : mPosition)
+        position = cty;
+    }
+
+    /**
+     * @return the maximal number of elements contained in the StaticPriorityQueue
+     */
+    size_t capacity() const
+    {
+      return cty;
+    }
+
+    /**
+     * @return the current number of elements contained in the StaticPriorityQueue
+     */
+    size_t size() const
+    {
+      return mSize;
+    }
+
+    /**
+     * @return true if the StaticPriorityQueue contains no element
+     */
+    bool empty() const
+    {
+      return mSize == 0;
+    }
+
+    /**
+     * @brief Adds an element to the queue in O(log n)
+     * @param val the value of the element
+     * @return the handle of the element, INVALID_HANDLE if the queue is full
+     */
+    handle_t push(const T &val)
+    {
+      if (mSize == cty)
+        return INVALID_HANDLE;
+
+      const handle_t handle = mHandles.acquire();
+      sift_up(mSize++, {val, handles_t::index(handle)});
+      return handle;
+    }
+
+    /**
+     * @return a pointer to the top element, or nullptr if the queue is empty
+     */
+    const T *top() const
+    {
+      return mSize ? &mHeap[0].value : nullptr;
+    }
+
+    /**
+     * @return the handle of the top element, or INVALID_HANDLE if the queue is empty
+     */
+    handle_t top_handle() const
+    {
+      return mSize ? mHandles.handle(mHeap[0].slot) : INVALID_HANDLE;
+    }
+
+    /**
+     * @brief Removes the top element in O(log n)
+     * @return a std::optional containing the top element if the queue was not empty else an empty optional
+     */
+    std::optional<T> pop()
+    {
+      if (mSize == 0)
+        return {};
+      const T val = mHeap[0].value;
+      remove_at(0);
+      return val;
+    }
+
+    /**
+     * @param handle a handle returned by push
+     * @return true if the element of the handle is still in the queue
+     */
+    bool contains(handle_t handle) const
+    {
+      return mHandles.matches(handle) && mPosition[handles_t::index(handle)] != cty;
+    }
+
+    /**
+     * @param handle a handle returned by push
+     * @return a pointer to the element of the handle, or nullptr if it left the queue
+     */
+    const T *get(handle_t handle) const
+    {
+      return contains(handle) ? &mHeap[mPosition[handles_t::index(handle)]].value : nullptr;
+    }
+
+    /**
+     * @brief Changes the value of an element and restores the heap order in O(log n). It covers both decrease-key and
+     * increase-key
+     * @param handle a handle returned by push
+     * @param val the new value of the element
+     * @return true if the element was updated else false (the element left the queue)
+     */
+    bool update(handle_t handle, const T &val)
+    {
+      if (!contains(handle))
+        return false;
+      const cty_t slot = handles_t::index(handle);
+      const size_t i = mPosition[slot];
+      if (Compare{}(mHeap[i].value, val))
+        sift_up(i, {val, slot});
+      else
+        sift_down(i, {val, slot});
+      return true;
+    }
+
+    /**
+     * @brief Removes an element in O(log n), its handle is released
+     * @param handle a handle returned by push
+     * @return true if the element was removed else false (the element already left the queue)
+     */
+    bool erase(handle_t handle)
+    {
+      if (!contains(handle))
+        return false;
+      remove_at(mPosition[handles_t::index(handle)]);
+      return true;
+    }
+
+    /**
+     * @brief Removes all the elements, all the handles are released
+     */
+    void clear()
+    {
+      for (size_t i = 0; i < mSize; ++i)
+      {
+        mPosition[mHeap[i].slot] = cty;
+        mHandles.release(mHeap[i].slot);
+      }
+      mSize = 0;
+    }
+
+  private:
+    struct Node
+    {
+      T value;
+      cty_t slot; // The index of the handle of the element
+    };
+
+    static constexpr size_t arity = 4;
+
+    void place(size_t i, const Node &node)
+    {
+      mHeap[i] = node;
+      mPosition[node.slot] = i;
+    }
+
+    // Moves the hole at i up to the position of node and fills it
+    void sift_up(size_t i, const Node &node)
+    {
+      while (i > 0)
+      {
+        const size_t parent = (i - 1) / arity;
+        if (!Compare{}(mHeap[parent].value, node.value))
+          break;
+        place(i, mHeap[parent]);
+        i = parent;
+      }
+      place(i, node);
+    }
+
+    // Moves the hole at i down to the position of node and fills it
+    void sift_down(size_t i, const Node &node)
+    {
+      for (;;)
+      {
+        const size_t first = i * arity + 1;
+        if (first >= mSize)
+          break;
+        const size_t last = first + arity < mSize ? first + arity : mSize;
+        size_t best = first;
+        for (size_t child = first + 1; child < last; ++child)
+        {
+          if (Compare{}(mHeap[best].value, mHeap[child].value))
+            best = child;
+        }
+        if (!Compare{}(node.value, mHeap[best].value))
+          break;
+        place(i, mHeap[best]);
+        i = best;
+      }
+      place(i, node);
+    }
+
+    void remove_at(size_t i)
+    {
+      const cty_t slot = mHeap[i].slot;
+      mPosition[slot] = cty;
+      mHandles.release(slot);
+      if (i == --mSize)
+        return;
+
+      // The last element fills the hole, it may have to move either way when the hole is not the root
+      const Node last = mHeap[mSize];
+      if (i > 0 && Compare{}(mHeap[(i - 1) / arity].value, last.value))
+        sift_up(i, last);
+      else
+        sift_down(i, last);
+    }
+
+    Node mHeap[cty]{};
+    cty_t mPosition[cty]{};
+    handles_t mHandles;
+    cty_t mSize = 0;
+  };
+} // namespace esutils
+
+#endif // ESUTILS_STATIC_PRIORITY_QUEUE_HPP
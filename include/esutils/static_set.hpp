@@ -11,18 +11,26 @@
 
 #include <cstddef>
 #include <cstdint>
+#include "instrumentation.hpp"
 #include "type_capacity.hpp"
 
 namespace esutils
 {
-  template <typename T, uint16_t cty>
-  class StaticSet
+  /**
+   * @brief A set of at most cty elements
+   * @tparam T the type of the elements
+   * @tparam cty the maximal number of elements
+   * @tparam Instrumentation the policy recording the use of the StaticSet, see instrumentation.hpp
+   */
+  template <typename T, uint16_t cty, typename Instrumentation = NoInstrumentation>
+  class StaticSet : private Instrumentation
   {
     using cty_t = typename TypeCapacity<cty>::type;
 
   public:
     constexpr StaticSet()
       :
+      Instrumentation(),
       mSize(0),
       mStatus(),
       mData(),
@@ -33,14 +41,17 @@ namespace esutils
 
     constexpr void clear()
     {
-      mStatus.clear();
+      for (bool &status : mStatus)
+        status = false;
+      for (cty_t &forward : mForwardIndex)
+        forward = cty;
       mSize = 0;
     }
 
     template <bool constant>
     class ForwardIterator
     {
-      using set_t = std::conditional_t<constant, const StaticSet<T, cty>, StaticSet<T, cty>>;
+      using set_t = std::conditional_t<constant, const StaticSet, StaticSet>;
       using unref_t = std::conditional_t<constant, const T, T>;
 
     public:
@@ -125,6 +136,85 @@ namespace esutils
     }
 
     constexpr ForwardIterator<false> insert(const T &el)
+    {
+      const auto start = Instrumentation::start();
+      const size_t before = mSize;
+      const ForwardIterator<false> it = insert_element(el);
+      if (mSize != before)
+        Instrumentation::count(ContainerEvent::INSERTED);
+      else if (it == end())
+        Instrumentation::count(ContainerEvent::REJECTED);
+      Instrumentation::finish(mSize, start);
+      return it;
+    }
+
+    constexpr ForwardIterator<false> find(const T &el)
+    {
+      return {this, find_element_index(el)};
+    }
+
+    constexpr ForwardIterator<true> find(const T &el) const
+    {
+      return {this, find_element_index(el)};
+    }
+
+    constexpr bool erase(const T &el)
+    {
+      const auto start = Instrumentation::start();
+      const cty_t root = hash(el);
+      bool erased = false;
+      if (mStatus[root])
+      {
+        // The elements with the same index are chained from the root slot, or from the slot it forwards to
+        const cty_t head = hash(mData[root]) == root ? root : mForwardIndex[root];
+        cty_t found = cty;
+        cty_t previous = cty;
+        cty_t last = head;
+        while (last != cty)
+        {
+          if (mData[last] == el)
+            found = last;
+          if (mChild[last] == cty)
+            break;
+          previous = last;
+          last = mChild[last];
+        }
+        if (found != cty)
+        {
+          // The last element of the chain takes the place of the erased one, so that only the last slot is freed
+          mData[found] = mData[last];
+          if (previous != cty)
+            mChild[previous] = cty;
+          else if (head != root)
+            mForwardIndex[root] = cty;
+          release_slot(last);
+          mSize--;
+          erased = true;
+          Instrumentation::count(ContainerEvent::REMOVED);
+        }
+      }
+      Instrumentation::finish(mSize, start);
+      return erased;
+    }
+
+    /**
+     * @return the capacity, the size and the statistics recorded by the instrumentation policy
+     */
+    constexpr ContainerSnapshot snapshot() const
+    {
+      return Instrumentation::snapshot(cty, mSize);
+    }
+
+    /**
+     * @return the instrumentation policy, e.g. to reset its statistics
+     */
+    constexpr Instrumentation &instrumentation()
+    {
+      return *this;
+    }
+
+  private:
+    constexpr ForwardIterator<false> insert_element(const T &el)
     {
       if (mSize < cty)
       {
@@ -195,27 +285,6 @@ namespace esutils
       }
     }
 
-    constexpr ForwardIterator<false> find(const T &el)
-    {
-      return {this, find_element_index(el)};
-    }
-
-    constexpr ForwardIterator<true> find(const T &el) const
-    {
-      return {this, find_element_index(el)};
-    }
-
-    constexpr bool erase(const T &el)
-    {
-      cty_t i = find_element_index(el);
-      if (i == cty)
-        return false;
-      erase_cell_recursive(i);
-      mSize--;
-      return true;
-    }
-
-  private:
     constexpr cty_t find_element_index(const T &el) const
     {
       cty_t i = hash(el);
@@ -235,32 +304,21 @@ namespace esutils
       return cty;
     }
 
-    constexpr void erase_cell_recursive(cty_t i) // TODO Extensive tests, there seems to be a bug here
+    /**
+     * @brief Frees slot i once its element has been moved or erased. If i is the root index of elements stored elsewhere,
+     * the first of them is moved to i and its own slot is freed in turn, so that a free slot never forwards
+     */
+    constexpr void release_slot(cty_t i)
     {
-      if (mChild[i] == cty) // Last child in children chain
+      while (mForwardIndex[i] != cty)
       {
-        if (mForwardIndex[i] == cty) // No forwarding from this cell
-        {
-          mStatus[i] = false;
-        }
-        else // Copy forwarded cell and recursive erase forwarded cell
-        {
-          mData[i] = mData[mForwardIndex[i]];
-          erase_cell_recursive(mForwardIndex[i]);
-          if ((mStatus[mForwardIndex[i]] == false) || (hash(mData[mForwardIndex[i]]) != hash(mData[i])))
-            mChild[i] = cty;
-          else
-            mChild[i] = mForwardIndex[i];
-          mForwardIndex[i] = cty;
-        }
-      }
-      else
-      {
-        mData[i] = mData[mChild[i]];
-        erase_cell_recursive(mChild[i]);
-        if ((mStatus[mChild[i]] == false) || (hash(mData[mChild[i]]) != hash(mData[i])))
-          mChild[i] = cty;
+        const cty_t head = mForwardIndex[i];
+        mData[i] = mData[head];
+        mChild[i] = mChild[head];
+        mForwardIndex[i] = cty;
+        i = head;
       }
+      mStatus[i] = false;
     }
 
     constexpr uint16_t make_mask(const uint16_t x) const
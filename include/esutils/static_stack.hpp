@@ -10,12 +10,19 @@
 #include <cstddef>
 #include <optional>
 
+#include "instrumentation.hpp"
 #include "type_capacity.hpp"
 
 namespace esutils
 {
-  template <typename T, size_t cty>
-  class StaticStack
+  /**
+   * @brief A stack of at most cty elements
+   * @tparam T the type of the elements
+   * @tparam cty the maximal number of elements
+   * @tparam Instrumentation the policy recording the use of the StaticStack, see instrumentation.hpp
+   */
+  template <typename T, size_t cty, typename Instrumentation = NoInstrumentation>
+  class StaticStack : private Instrumentation
   {
   public:
     constexpr StaticStack() = default;
@@ -23,7 +30,7 @@ namespace esutils
     /**
      * @return the maximal number of elements contained in the StaticStack
      */
-    size_t capacity() const
+    constexpr size_t capacity() const
     {
       return cty;
     }
@@ -31,7 +38,7 @@ namespace esutils
     /**
      * @return the current number of elements contained in the StaticStack
      */
-    size_t size() const
+    constexpr size_t size() const
     {
       return mSize;
     }
@@ -41,30 +48,48 @@ namespace esutils
      * @param val the value to be added to the stack
      * @return true if the element was added else false (stack full)
      */
-    bool push(const T &val)
+    constexpr bool push(const T &val)
     {
-      if (mSize < cty)
+      const auto start = Instrumentation::start();
+      const bool pushed = mSize < cty;
+      if (pushed)
       {
         mData[mSize++] = val;
-        return true;
-      }
-      else
-      {
-        return false;
       }
+      Instrumentation::count(pushed ? ContainerEvent::INSERTED : ContainerEvent::REJECTED);
+      Instrumentation::finish(mSize, start);
+      return pushed;
     }
 
     /**
      * @brief Remove the top element from the stack
      * @return a std::optional containing the top element if the StaticStack size was >= 1 else an empty optional
      */
-    std::optional<T> pop()
+    constexpr std::optional<T> pop()
+    {
+      const auto start = Instrumentation::start();
+      const bool popped = mSize != 0;
+      // Constructed at once: the assignment of a std::optional is not constexpr before C++20
+      const std::optional<T> val = popped ? std::optional<T>(mData[--mSize]) : std::nullopt;
+      if (popped)
+        Instrumentation::count(ContainerEvent::REMOVED);
+      Instrumentation::finish(mSize, start);
+      return val;
+    }
+
+    /**
+     * @brief Finds an element in the stack
+     * @param val the value to be found
+     * @return a pointer to the data if it was found or nullptr
+     */
+    constexpr T *find(const T &val)
     {
-      if (mSize)
+      size_t i = find_idx(val);
+      if (i != mSize)
       {
-        return mData[--mSize];
+        return mData + i;
       }
-      return {};
+      return nullptr;
     }
 
     /**
@@ -72,7 +97,7 @@ namespace esutils
      * @param val the value to be found
      * @return a pointer to the data if it was found or nullptr
      */
-    T *find(const T &val)
+    constexpr const T *find(const T &val) const
     {
       size_t i = find_idx(val);
       if (i != mSize)
@@ -87,22 +112,33 @@ namespace esutils
      * @param val the value to be erased
      * @return true if the value was erased else false (the value did not exist in the stack)
      */
-    bool erase(const T &val)
+    constexpr bool erase(const T &val)
     {
+      const auto start = Instrumentation::start();
       size_t i = find_idx(val);
-      if (i != mSize)
+      const bool erased = i != mSize;
+      if (erased)
       {
         tidy(i + 1);
         mSize--;
-        return true;
+        Instrumentation::count(ContainerEvent::REMOVED);
       }
-      return false;
+      Instrumentation::finish(mSize, start);
+      return erased;
+    }
+
+    /**
+     * @return an iterator to the bottom of the stack
+     */
+    constexpr T *begin()
+    {
+      return mData;
     }
 
     /**
      * @return an iterator to the bottom of the stack
      */
-    T *begin()
+    constexpr const T *begin() const
     {
       return mData;
     }
@@ -110,13 +146,37 @@ namespace esutils
     /**
      * @return an iterator to the top of the stack
      */
-    T *end()
+    constexpr T *end()
+    {
+      return mData + mSize;
+    }
+
+    /**
+     * @return an iterator to the top of the stack
+     */
+    constexpr const T *end() const
     {
       return mData + mSize;
     }
 
+    /**
+     * @return the capacity, the size and the statistics recorded by the instrumentation policy
+     */
+    constexpr ContainerSnapshot snapshot() const
+    {
+      return Instrumentation::snapshot(cty, mSize);
+    }
+
+    /**
+     * @return the instrumentation policy, e.g. to reset its statistics
+     */
+    constexpr Instrumentation &instrumentation()
+    {
+      return *this;
+    }
+
   private:
-    size_t find_idx(const T &val)
+    constexpr size_t find_idx(const T &val) const
     {
       for (size_t i = 0; i < mSize; ++i)
       {
@@ -128,12 +188,12 @@ namespace esutils
       return mSize;
     }
 
-    void tidy(size_t i)
+    // Iterative so that erasing from a large stack stays within the constexpr evaluation depth
+    constexpr void tidy(size_t i)
     {
-      if (i < mSize)
+      for (; i < mSize; ++i)
       {
         mData[i - 1] = mData[i];
-        tidy(i + 1);
       }
     }
 
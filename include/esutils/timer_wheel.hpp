@@ -0,0 +1,303 @@
+#ifndef ESUTILS_TIMER_WHEEL_HPP
+#define ESUTILS_TIMER_WHEEL_HPP
+
+/**
+ * @file timer_wheel.hpp
+ * Definition of a hierarchical timer wheel with a capacity fixed at compile time
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "handle_pool.hpp"
+#include "hierarchical_bitmap.hpp"
+#include "type_capacity.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief A hierarchical timer wheel: level l has 64 slots covering 64^l ticks each. A timer goes to the level matching
+   * its remaining delay and is moved down one level (cascaded) when the wheel reaches its slot, so starting and
+   * cancelling a timer are O(1) and each timer is touched at most levels times before it expires. Timers cancelled
+   * before expiring, the common case for timeouts, never cost more than their start.
+   * The timers of a slot are linked in an intrusive list through a pool of cty nodes, and a bitmap of non empty slots
+   * per level lets advance() jump over empty slots.
+   * Handles carry a generation (see HandlePool): the handle of a timer that expired or was cancelled is rejected, even
+   * once its node runs another timer, so cancelling a timeout that already fired is harmless.
+   * @tparam T the type of the value attached to each timer, given back when it expires
+   * @tparam cty the maximal number of running timers
+   * @tparam levels the number of levels in [1, 5], the maximal delay is 64^levels - 1 ticks
+   */
+  template <typename T, size_t cty, size_t levels = 4>
+  class TimerWheel
+  {
+    static_assert(cty > 0, "The capacity must be at least 1");
+    static_assert(levels >= 1 && levels <= 5, "The delays must fit in 30 bits");
+
+    using cty_t = typename TypeCapacity<cty>::type;
+    using handles_t = HandlePool<cty>;
+
+  public:
+    /**
+     * @brief The type of the handles
+     */
+    using handle_t = typename handles_t::handle_t;
+
+    /**
+     * @brief The type of the ticks, the wheel keeps working when the current tick wraps around
+     */
+    using tick_t = uint32_t;
+
+    /**
+     * @brief The handle returned when a timer cannot be started
+     */
+    static constexpr handle_t INVALID_HANDLE = handles_t::INVALID_HANDLE;
+
+    /**
+     * @return the longest delay accepted by start()
+     */
+    static constexpr tick_t max_delay()
+    {
+      return (tick_t{1} << (slotBits * levels)) - 1;
+    }
+
+    TimerWheel()
+    {
+      for (auto &head : mHeads)
+        head = nil;
+    }
+
+    /**
+     * @return the maximal number of running timers
+     */
+    size_t capacity() const
+    {
+      return cty;
+    }
+
+    /**
+     * @return the number of running timers
+     */
+    size_t size() const
+    {
+      return mSize;
+    }
+
+    /**
+     * @return the current tick
+     */
+    tick_t now() const
+    {
+      return mNow;
+    }
+
+    /**
+     * @brief Starts a timer in O(1)
+     * @param delay the number of ticks before the timer expires, in the range [1, max_delay()]. A delay of 0 is
+     * treated as 1: the timer expires during the next tick
+     * @param value the value given back when the timer expires
+     * @return the handle of the timer, or INVALID_HANDLE if the delay is too long or if cty timers are running
+     */
+    handle_t start(tick_t delay, const T &value)
+    {
+      if (mSize == cty || delay > max_delay())
+        return INVALID_HANDLE;
+
+      const handle_t handle = mHandles.acquire();
+      const cty_t index = handles_t::index(handle);
+      ++mSize;
+      Node &node = mNodes[index];
+      node.value = value;
+      node.expiry = mNow + (delay ? delay : 1);
+      link(index);
+      return handle;
+    }
+
+    /**
+     * @brief Stops a timer in O(1) before it expires, its handle is released
+     * @param handle a handle returned by start
+     * @return true if the timer was stopped else false (it already expired or was cancelled)
+     */
+    bool cancel(handle_t handle)
+    {
+      if (!active(handle))
+        return false;
+      const cty_t index = handles_t::index(handle);
+      unlink(index);
+      release(index);
+      return true;
+    }
+
+    /**
+     * @param handle a handle returned by start
+     * @return true if the timer is running
+     */
+    bool active(handle_t handle) const
+    {
+      return mHandles.matches(handle) && mNodes[handles_t::index(handle)].bucket != noBucket;
+    }
+
+    /**
+     * @param handle a handle returned by start
+     * @return a pointer to the value of the timer, or nullptr if it is not running
+     */
+    T *get(handle_t handle)
+    {
+      return active(handle) ? &mNodes[handles_t::index(handle)].value : nullptr;
+    }
+
+    /**
+     * @param handle a handle returned by start
+     * @return the number of ticks before the timer expires, 0 if it is not running
+     */
+    tick_t remaining(handle_t handle) const
+    {
+      return active(handle) ? mNodes[handles_t::index(handle)].expiry - mNow : 0;
+    }
+
+    /**
+     * @brief Moves the wheel forward and expires the timers that are due, in the order of their expiry. The ticks
+     * without any timer to expire or to cascade are skipped, so a long advance on a sparse wheel is cheap.
+     * The handle of an expired timer is released before the callback is called, which may start or cancel timers
+     * @param ticks the number of ticks to move forward
+     * @param callback a callable taking (handle_t handle, const T &value), called for each expired timer
+     * @return the number of expired timers
+     */
+    template <typename Callback>
+    size_t advance(tick_t ticks, Callback &&callback)
+    {
+      size_t expired = 0;
+      while (ticks)
+      {
+        // Jump to the next tick that has a timer in level 0 or that cascades the upper levels
+        const size_t current = mNow & slotMask;
+        const size_t next = mOccupied[0].find_next(current);
+        const tick_t step = static_cast<tick_t>((next < slots ? next : slots) - current);
+        if (step > ticks)
+        {
+          mNow += ticks;
+          break;
+        }
+        mNow += step;
+        ticks -= step;
+
+        cascade();
+        const size_t bucket = mNow & slotMask;
+        while (mHeads[bucket] != nil)
+        {
+          const cty_t index = mHeads[bucket];
+          unlink(index);
+          const T value = mNodes[index].value;
+          const handle_t handle = mHandles.handle(index);
+          release(index);
+          ++expired;
+          callback(handle, value);
+        }
+      }
+      return expired;
+    }
+
+    /**
+     * @brief Stops all the timers, all the handles are released
+     */
+    void clear()
+    {
+      for (size_t bucket = 0; bucket < slots * levels; ++bucket)
+      {
+        while (mHeads[bucket] != nil)
+        {
+          const cty_t index = mHeads[bucket];
+          unlink(index);
+          release(index);
+        }
+      }
+    }
+
+  private:
+    static constexpr size_t slotBits = 6;
+    static constexpr size_t slots = size_t{1} << slotBits;
+    static constexpr size_t slotMask = slots - 1;
+    static constexpr cty_t nil = cty;
+    static constexpr uint16_t noBucket = slots * levels;
+
+    struct Node
+    {
+      T value{};
+      tick_t expiry = 0;
+      cty_t prev = nil;
+      cty_t next = nil;
+      uint16_t bucket = noBucket;
+    };
+
+    // The level of a timer is given by its remaining delay and its slot by the bits of its expiry at that level,
+    // so that the slot is reached exactly when the remaining delay fits in the level below
+    void link(cty_t index)
+    {
+      Node &node = mNodes[index];
+      const tick_t delay = node.expiry - mNow;
+      size_t level = 0;
+      while (level + 1 < levels && (delay >> (slotBits * (level + 1))) != 0)
+        ++level;
+      const size_t slot = (node.expiry >> (slotBits * level)) & slotMask;
+      const size_t bucket = level * slots + slot;
+
+      node.bucket = bucket;
+      node.prev = nil;
+      node.next = mHeads[bucket];
+      if (node.next != nil)
+        mNodes[node.next].prev = index;
+      else
+        mOccupied[level].set(slot);
+      mHeads[bucket] = index;
+    }
+
+    void unlink(cty_t index)
+    {
+      Node &node = mNodes[index];
+      if (node.prev != nil)
+        mNodes[node.prev].next = node.next;
+      else
+        mHeads[node.bucket] = node.next;
+      if (node.next != nil)
+        mNodes[node.next].prev = node.prev;
+      if (mHeads[node.bucket] == nil)
+        mOccupied[node.bucket / slots].reset(node.bucket % slots);
+    }
+
+    void release(cty_t index)
+    {
+      mNodes[index].bucket = noBucket;
+      mHandles.release(index);
+      --mSize;
+    }
+
+    // Moves the timers of the slots reached by the current tick down, starting with the highest level
+    void cascade()
+    {
+      size_t level = 1;
+      while (level < levels && (mNow & ((tick_t{1} << (slotBits * level)) - 1)) == 0)
+        ++level;
+      while (--level > 0)
+      {
+        const size_t slot = (mNow >> (slotBits * level)) & slotMask;
+        const size_t bucket = level * slots + slot;
+        while (mHeads[bucket] != nil)
+        {
+          const cty_t index = mHeads[bucket];
+          unlink(index);
+          link(index);
+        }
+      }
+    }
+
+    Node mNodes[cty]{};
+    cty_t mHeads[slots * levels]{};
+    HierarchicalBitmap<slots> mOccupied[levels]{};
+    handles_t mHandles;
+    cty_t mSize = 0;
+    tick_t mNow = 0;
+  };
+} // namespace esutils
+
+#endif // ESUTILS_TIMER_WHEEL_HPP
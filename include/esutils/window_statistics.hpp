@@ -0,0 +1,457 @@
+#ifndef ESUTILS_WINDOW_STATISTICS_HPP
+#define ESUTILS_WINDOW_STATISTICS_HPP
+
+/**
+ * @file window_statistics.hpp
+ * Streaming statistics over the last samples of a signal (min, max, mean, variance and percentiles), with O(1)
+ * amortized updates and no dynamic allocation
+ * @author Etienne Santoul
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#include "ring_buffer.hpp"
+#include "type_capacity.hpp"
+
+namespace esutils
+{
+  /**
+   * @brief The extremum of the last length samples, kept in a monotonic deque: a sample is dropped as soon as a newer
+   * one dominates it since it can never be the extremum again. Each sample is pushed and dropped at most once so an
+   * update is O(1) amortized and the extremum is read in O(1)
+   * @tparam T the type of the samples
+   * @tparam length the number of samples in the window
+   * @tparam Compare std::less<T> keeps the minimum, std::greater<T> the maximum
+   */
+  template <typename T, size_t length, typename Compare>
+  class SlidingExtremum
+  {
+    static_assert(length > 0, "The window must contain at least one sample");
+
+  public:
+    constexpr SlidingExtremum() = default;
+
+    /**
+     * @brief Adds a sample to the window, the oldest one leaves it if the window is full
+     * @param x the new sample
+     */
+    constexpr void push(const T &x)
+    {
+      if (mSize != 0)
+      {
+        const seq_t age = mCount - mSequence[mHead];
+        if (age >= length)
+        {
+          mHead = wrap(mHead + 1);
+          --mSize;
+        }
+      }
+      while (mSize != 0 && !Compare{}(mValues[wrap(mHead + mSize - 1)], x))
+        --mSize;
+
+      const size_t back = wrap(mHead + mSize);
+      mValues[back] = x;
+      mSequence[back] = mCount;
+      ++mSize;
+      ++mCount;
+    }
+
+    /**
+     * @return the extremum of the samples in the window, T{} if no sample was pushed
+     */
+    constexpr T value() const
+    {
+      return mSize != 0 ? mValues[mHead] : T{};
+    }
+
+    /**
+     * @brief Empties the window
+     */
+    constexpr void clear()
+    {
+      mHead = mSize = 0;
+      mCount = 0;
+    }
+
+  private:
+    static constexpr size_t wrap(size_t i)
+    {
+      return i >= length ? i - length : i;
+    }
+
+    // Sequence numbers wrap around, only the age of a sample, which is at most length, must be representable
+    using seq_t = typename TypeCapacity<length>::type;
+    using cty_t = typename TypeCapacity<length>::type;
+
+    T mValues[length]{};
+    seq_t mSequence[length]{};
+    seq_t mCount = 0;
+    cty_t mHead = 0;
+    cty_t mSize = 0;
+  };
+
+  template <typename T, size_t length>
+  using SlidingMin = SlidingExtremum<T, length, std::less<T>>;
+
+  template <typename T, size_t length>
+  using SlidingMax = SlidingExtremum<T, length, std::greater<T>>;
+
+  /**
+   * @brief A histogram over [low, high] with bins of equal width, used to approximate the percentiles of a window.
+   * Samples outside of the range are counted in the first or the last bin
+   * @tparam T the type of the samples
+   * @tparam bins the number of bins
+   * @tparam length the maximal number of samples counted at the same time
+   */
+  template <typename T, size_t bins, size_t length>
+  class WindowHistogram
+  {
+    static_assert(bins > 0, "The histogram must have at least one bin");
+    static_assert(std::is_floating_point_v<T> || sizeof(T) <= 4, "Integral samples must fit in 32 bits");
+
+  public:
+    using real_t = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+    constexpr WindowHistogram() = default;
+
+    /**
+     * @param low the lower bound of the first bin
+     * @param high the upper bound of the last bin, must be greater than low
+     */
+    constexpr WindowHistogram(T low, T high) : mLow(low), mHigh(high) {}
+
+    /**
+     * @brief Counts a sample
+     * @param x the sample entering the window
+     */
+    constexpr void add(const T &x)
+    {
+      ++mCounts[bin(x)];
+      ++mTotal;
+    }
+
+    /**
+     * @brief Forgets a sample that was previously added
+     * @param x the sample leaving the window
+     */
+    constexpr void remove(const T &x)
+    {
+      --mCounts[bin(x)];
+      --mTotal;
+    }
+
+    /**
+     * @brief Approximates a percentile by interpolating linearly inside the bin that contains it. For samples in
+     * [low, high], the error is less than one bin width. The cost is O(bins)
+     * @param p the rank of the percentile in [0, 1] (0.5 for the median)
+     * @return the approximated percentile, low if no sample is counted
+     */
+    constexpr real_t percentile(real_t p) const
+    {
+      const real_t low = mLow;
+      if (mTotal == 0)
+        return low;
+
+      const real_t target = p * static_cast<real_t>(mTotal);
+      real_t before = 0;
+      size_t i = 0;
+      for (; i + 1 < bins; ++i)
+      {
+        if (before + static_cast<real_t>(mCounts[i]) >= target && mCounts[i] != 0)
+          break;
+        before += static_cast<real_t>(mCounts[i]);
+      }
+      const real_t inBin = mCounts[i] != 0 ? (target - before) / static_cast<real_t>(mCounts[i]) : 0;
+      const real_t position = static_cast<real_t>(i) + (inBin < 1 ? inBin : 1);
+      return low + position * span() / static_cast<real_t>(bins);
+    }
+
+    /**
+     * @param i the index of a bin in the range [0, bins[
+     * @return the number of samples counted in the bin
+     */
+    constexpr size_t count(size_t i) const
+    {
+      return mCounts[i];
+    }
+
+    /**
+     * @return the number of samples counted
+     */
+    constexpr size_t size() const
+    {
+      return mTotal;
+    }
+
+    /**
+     * @brief Forgets all the samples
+     */
+    constexpr void clear()
+    {
+      for (auto &c : mCounts)
+        c = 0;
+      mTotal = 0;
+    }
+
+  private:
+    // Integral samples are binned with integer arithmetic only, each value of [low, high] is in exactly one bin
+    constexpr real_t span() const
+    {
+      const real_t low = mLow;
+      const real_t high = mHigh;
+      if constexpr (std::is_floating_point_v<T>)
+        return high - low;
+      else
+        return high - low + 1;
+    }
+
+    constexpr size_t bin(const T &x) const
+    {
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        const T position = (x - mLow) * static_cast<T>(bins) / (mHigh - mLow);
+        if (!(position > 0)) // NaN goes to the first bin
+          return 0;
+        return position < static_cast<T>(bins) ? static_cast<size_t>(position) : bins - 1;
+      }
+      else
+      {
+        using wide_t = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+        if (x <= mLow)
+          return 0;
+        if (x >= mHigh)
+          return bins - 1;
+        const uint64_t offset = wide_t{x} - wide_t{mLow};
+        const uint64_t width = wide_t{mHigh} - wide_t{mLow};
+        return offset * bins / (width + 1);
+      }
+    }
+
+    using cty_t = typename TypeCapacity<length>::type;
+
+    T mLow = 0;
+    T mHigh = std::numeric_limits<T>::max();
+    cty_t mCounts[bins]{};
+    cty_t mTotal = 0;
+  };
+
+  /**
+   * @brief An empty histogram for windows without percentiles
+   */
+  template <typename T, size_t length>
+  class WindowHistogram<T, 0, length>
+  {
+  public:
+    constexpr WindowHistogram() = default;
+    constexpr void add(const T &) {}
+    constexpr void remove(const T &) {}
+    constexpr void clear() {}
+  };
+
+  /**
+   * @brief Statistics of the last length samples of a signal. The samples are kept in a RingBuffer so that the
+   * statistics are updated from the entering and the leaving sample only: push() is O(1) amortized whatever the
+   * length of the window.
+   * The sum of integral samples is exact. The variance uses Welford's update, extended to replace the oldest sample of
+   * a full window, which stays accurate where the naive sum of squares cancels catastrophically
+   * @tparam T the type of the samples
+   * @tparam length the number of samples in the window
+   * @tparam bins the number of bins of the histogram used to approximate percentiles, 0 disables percentile()
+   */
+  template <typename T, size_t length, size_t bins = 0>
+  class WindowStatistics
+  {
+    static_assert(length > 0, "The window must contain at least one sample");
+
+  public:
+    using real_t = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+    using sum_t = std::conditional_t<std::is_floating_point_v<T>, T,
+                                     std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+    WindowStatistics() = default;
+
+    /**
+     * @brief Creates the statistics of a window whose percentiles are approximated with a histogram over [low, high]
+     * @param low the lower bound of the histogram
+     * @param high the upper bound of the histogram, must be greater than low
+     */
+    template <size_t b = bins, std::enable_if_t<b != 0, bool> = true>
+    WindowStatistics(T low, T high) : mHistogram(low, high)
+    {
+    }
+
+    /**
+     * @brief Adds a sample to the window, the oldest one leaves it if the window is full
+     * @param x the new sample
+     */
+    void push(const T &x)
+    {
+      mMin.push(x);
+      mMax.push(x);
+      mHistogram.add(x);
+
+      const real_t value = x;
+      if (mSamples.writable())
+      {
+        mSamples.write(x);
+        const real_t delta = value - mMean;
+        mMean += delta / static_cast<real_t>(mSamples.readable());
+        mM2 += delta * (value - mMean);
+        if constexpr (!std::is_floating_point_v<T>)
+          mSum += x;
+      }
+      else
+      {
+        const T oldest = *mSamples.peek();
+        mSamples.overwrite(x);
+        mHistogram.remove(oldest);
+        const real_t old = oldest;
+        const real_t mean = mMean + (value - old) / static_cast<real_t>(length);
+        mM2 += (value - old) * (value - mean + old - mMean);
+        mMean = mean;
+        if constexpr (!std::is_floating_point_v<T>)
+          mSum += sum_t{x} - sum_t{oldest};
+        if (++mSinceResync == length)
+          resync();
+      }
+    }
+
+    /**
+     * @brief Adds multiple samples to the window
+     * @param x a pointer to the first sample
+     * @param count the number of samples
+     */
+    void push(const T *x, size_t count)
+    {
+      for (size_t i = 0; i < count; ++i)
+        push(x[i]);
+    }
+
+    /**
+     * @return the number of samples in the window, length once it is full
+     */
+    size_t size() const
+    {
+      return mSamples.readable();
+    }
+
+    /**
+     * @return the smallest sample in the window, T{} if it is empty
+     */
+    T min() const
+    {
+      return mMin.value();
+    }
+
+    /**
+     * @return the largest sample in the window, T{} if it is empty
+     */
+    T max() const
+    {
+      return mMax.value();
+    }
+
+    /**
+     * @return the sum of the samples in the window, exact for integral samples
+     */
+    sum_t sum() const
+    {
+      if constexpr (std::is_floating_point_v<T>)
+        return mMean * static_cast<real_t>(size());
+      else
+        return mSum;
+    }
+
+    /**
+     * @return the mean of the samples in the window, 0 if it is empty
+     */
+    real_t mean() const
+    {
+      if constexpr (std::is_floating_point_v<T>)
+        return mMean;
+      else
+        return size() != 0 ? static_cast<real_t>(mSum) / static_cast<real_t>(size()) : 0;
+    }
+
+    /**
+     * @return the population variance of the samples in the window, 0 if it is empty
+     */
+    real_t variance() const
+    {
+      return size() != 0 ? squares() / static_cast<real_t>(size()) : 0;
+    }
+
+    /**
+     * @return the unbiased sample variance of the samples in the window, 0 if it contains less than 2 samples
+     */
+    real_t sample_variance() const
+    {
+      return size() > 1 ? squares() / static_cast<real_t>(size() - 1) : 0;
+    }
+
+    /**
+     * @brief Approximates a percentile of the samples in the window, see WindowHistogram::percentile
+     * @param p the rank of the percentile in [0, 1] (0.5 for the median)
+     */
+    real_t percentile(real_t p) const
+    {
+      static_assert(bins != 0, "Percentiles need a histogram: set bins");
+      return mHistogram.percentile(p);
+    }
+
+    /**
+     * @brief Empties the window
+     */
+    void clear()
+    {
+      mSamples.clear();
+      mMin.clear();
+      mMax.clear();
+      mHistogram.clear();
+      mSum = 0;
+      mMean = mM2 = 0;
+      mSinceResync = 0;
+    }
+
+  private:
+    // The rounding errors of the updates accumulate: the mean and the squared deviations are recomputed from the
+    // samples once per window, which keeps push() O(1) amortized
+    void resync()
+    {
+      real_t mean = 0;
+      for (size_t i = 0; i < length; ++i)
+        mean += mSamples[i];
+      mean /= static_cast<real_t>(length);
+      real_t m2 = 0;
+      for (size_t i = 0; i < length; ++i)
+      {
+        const real_t deviation = mSamples[i] - mean;
+        m2 += deviation * deviation;
+      }
+      mMean = mean;
+      mM2 = m2;
+      mSinceResync = 0;
+    }
+
+    // Rounding errors may bring the sum of squared deviations slightly below 0 when all the samples are equal
+    real_t squares() const
+    {
+      return mM2 > 0 ? mM2 : 0;
+    }
+
+    RingBuffer<T, length> mSamples;
+    SlidingMin<T, length> mMin;
+    SlidingMax<T, length> mMax;
+    WindowHistogram<T, bins, length> mHistogram;
+    sum_t mSum = 0;
+    real_t mMean = 0;
+    real_t mM2 = 0;
+    typename TypeCapacity<length>::type mSinceResync = 0;
+  };
+} // namespace esutils
+
+#endif // ESUTILS_WINDOW_STATISTICS_HPP
@@ -0,0 +1,72 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/algorithms.hpp"
+
+namespace
+{
+  static_assert(esutils::curvegen<0>(int16_t{12345}) == 12345);
+  static_assert(esutils::curvegen<127>(int16_t{16384}) == 8192 + 4096);
+  static_assert(esutils::curvegen<-127>(int16_t{16384}) == 16384 + 4096);
+
+  template <int8_t alpha, typename T>
+  void checkFixedPoint(int64_t step)
+  {
+    constexpr int digits = std::numeric_limits<T>::digits;
+    const double scale = std::ldexp(1.0, digits);
+    for (int64_t x = 0; x <= std::numeric_limits<T>::max(); x += step)
+    {
+      const double expected = esutils::curvegen<alpha>(static_cast<double>(x) / scale) * scale;
+      REQUIRE(std::abs(static_cast<double>(esutils::curvegen<alpha>(static_cast<T>(x))) - expected) <= 1.0);
+    }
+  }
+
+  template <typename T>
+  void checkAllAlphas(int64_t step)
+  {
+    checkFixedPoint<-127, T>(step);
+    checkFixedPoint<-50, T>(step);
+    checkFixedPoint<0, T>(step);
+    checkFixedPoint<1, T>(step);
+    checkFixedPoint<64, T>(step);
+    checkFixedPoint<127, T>(step);
+  }
+}
+
+TEST_CASE("Curvegen", "[esutils]")
+{
+  SECTION("Floating point")
+  {
+    REQUIRE(esutils::curvegen<127>(0.5) == 0.375);
+    REQUIRE(esutils::curvegen<0>(0.3f) == 0.3f);
+    REQUIRE(esutils::curvegen<-127>(1.0) == 1.0);
+  }
+
+  SECTION("Fixed point matches the floating point curve")
+  {
+    checkAllAlphas<int16_t>(1);
+    checkAllAlphas<uint16_t>(1);
+    checkAllAlphas<int8_t>(1);
+    checkAllAlphas<int32_t>(65521);
+    checkAllAlphas<uint32_t>(65521);
+  }
+
+  SECTION("Batch")
+  {
+    std::vector<int16_t> in(1000);
+    for (size_t i = 0; i < in.size(); ++i)
+      in[i] = static_cast<int16_t>(i * 32);
+    std::vector<int16_t> out(in.size());
+    esutils::curvegen<90>(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+      REQUIRE(out[i] == esutils::curvegen<90>(in[i]));
+
+    // In place
+    esutils::curvegen<90>(in.data(), in.data(), in.size());
+    REQUIRE(in == out);
+  }
+}
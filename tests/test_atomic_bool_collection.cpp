@@ -0,0 +1,101 @@
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/atomic_bool_collection.hpp"
+
+TEST_CASE("Atomic Bool Collection", "[esutils]")
+{
+  SECTION("Basic usage")
+  {
+    esutils::AtomicBoolCollection<70> flags;
+
+    REQUIRE(flags.size() == 70);
+    for (size_t i = 0; i < flags.size(); ++i)
+    {
+      REQUIRE(flags[i] == false);
+    }
+
+    flags.set(3);
+    flags.set(69);
+    REQUIRE(flags[3] == true);
+    REQUIRE(flags[69] == true);
+    REQUIRE(flags[4] == false);
+
+    REQUIRE(flags.test_and_set(3) == true);
+    REQUIRE(flags.test_and_set(4) == false);
+    REQUIRE(flags[4] == true);
+
+    REQUIRE(flags.test_and_reset(4) == true);
+    REQUIRE(flags.test_and_reset(4) == false);
+
+    flags.flip(5);
+    REQUIRE(flags[5] == true);
+    flags.reset(5);
+    REQUIRE(flags[5] == false);
+  }
+
+  SECTION("Fetch and clear all")
+  {
+    esutils::AtomicBoolCollection<100, uint8_t> flags;
+    flags.set(0);
+    flags.set(42);
+    flags.set(99);
+
+    std::vector<size_t> reported;
+    REQUIRE(flags.fetch_and_clear_all([&](size_t i) { reported.push_back(i); }) == 3);
+    REQUIRE(reported == std::vector<size_t>{0, 42, 99});
+    REQUIRE(flags.fetch_and_clear_all([](size_t) {}) == 0);
+  }
+
+  SECTION("Claim first free never returns padding bits")
+  {
+    esutils::AtomicBoolCollection<10, uint8_t> slots;
+    for (size_t i = 0; i < 10; ++i)
+    {
+      REQUIRE(slots.claim_first_free() == i);
+    }
+    REQUIRE(slots.claim_first_free() == 10);
+
+    slots.reset(7);
+    REQUIRE(slots.claim_first_free() == 7);
+  }
+
+  SECTION("Concurrent claims are unique")
+  {
+    constexpr size_t nbSlots = 4000;
+    constexpr size_t nbThreads = 4;
+    esutils::AtomicBoolCollection<nbSlots> slots;
+    std::vector<std::vector<size_t>> claimed(nbThreads);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < nbThreads; ++t)
+    {
+      threads.emplace_back([&, t]() {
+        for (size_t i = 0; i < nbSlots / nbThreads; ++i)
+        {
+          claimed[t].push_back(slots.claim_first_free());
+        }
+      });
+    }
+    for (auto &th : threads)
+    {
+      th.join();
+    }
+
+    std::vector<bool> seen(nbSlots, false);
+    for (const auto &indices : claimed)
+    {
+      for (size_t i : indices)
+      {
+        REQUIRE(i < nbSlots);
+        REQUIRE(seen[i] == false);
+        seen[i] = true;
+      }
+    }
+    REQUIRE(slots.claim_first_free() == nbSlots);
+  }
+}
@@ -0,0 +1,69 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/bit_pack.hpp"
+
+namespace
+{
+  template <size_t bits, typename T, typename Underlying>
+  void checkRoundTrip(std::mt19937 &rng, size_t count)
+  {
+    const size_t words = (count * bits + std::numeric_limits<Underlying>::digits - 1) / std::numeric_limits<Underlying>::digits + 1;
+    std::vector<Underlying> packed(words);
+    for (auto &w : packed)
+      w = static_cast<Underlying>(rng());
+    const Underlying guard = packed.back();
+
+    uintmax_t mask = ~uintmax_t{0};
+    if constexpr (bits < std::numeric_limits<uintmax_t>::digits)
+      mask = (uintmax_t{1} << bits) - 1;
+
+    std::vector<T> values(count);
+    for (auto &v : values)
+      v = static_cast<T>(((uintmax_t{rng()} << 32) | rng()) & mask);
+
+    // Packing must produce the BitSliceReference layout
+    esutils::pack<bits>(values.data(), count, packed.data());
+    for (size_t i = 0; i < count; ++i)
+    {
+      REQUIRE(esutils::BitSliceReference<bits, T, const Underlying>(packed.data(), i) == values[i]);
+    }
+    REQUIRE(packed.back() == guard);
+
+    std::vector<T> unpacked(count);
+    esutils::unpack<bits>(static_cast<const Underlying *>(packed.data()), count, unpacked.data());
+    REQUIRE(unpacked == values);
+  }
+
+  template <typename T, typename Underlying, size_t... bits>
+  void checkAllSizes(std::mt19937 &rng, size_t count)
+  {
+    (checkRoundTrip<bits, T, Underlying>(rng, count), ...);
+  }
+
+  constexpr uint16_t unpackAtCompileTime()
+  {
+    const uint8_t packed[3] = {0xBC, 0x1A, 0x23};
+    uint16_t out[2]{};
+    esutils::unpack<12>(packed, 2, out);
+    return out[1];
+  }
+  static_assert(unpackAtCompileTime() == 0x231);
+}
+
+TEST_CASE("Bit Pack", "[esutils]")
+{
+  std::mt19937 rng(4);
+  for (size_t count : {0, 1, 7, 8, 31, 64, 333})
+  {
+    checkAllSizes<uint16_t, uint8_t, 1, 3, 8, 10, 12, 13, 16>(rng, count);
+    checkAllSizes<uint16_t, uint32_t, 1, 5, 10, 12, 16>(rng, count);
+    checkAllSizes<int16_t, uint64_t, 6, 12, 15>(rng, count);
+    checkAllSizes<uint32_t, uint16_t, 17, 24, 31>(rng, count);
+    checkAllSizes<uint64_t, uint32_t, 33, 48, 64>(rng, count);
+  }
+}
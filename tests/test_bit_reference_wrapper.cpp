@@ -1,3 +1,6 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -63,4 +66,71 @@ TEST_CASE("Bit Reference Wrapper", "[esutils]")
       REQUIRE(v == (0xFF & ~(1 << i)));
     }
   }
+
+  SECTION("Most significant bit of a wide type")
+  {
+    uint64_t v = 0;
+    esutils::BitReferenceWrapper ref(v, 63);
+    ref = true;
+    REQUIRE(v == uint64_t{1} << 63);
+    v = ~uint64_t{0};
+    ref = false;
+    REQUIRE(v == ~(uint64_t{1} << 63));
+  }
+}
+
+TEST_CASE("Atomic Bit Reference Wrapper", "[esutils]")
+{
+  SECTION("Single thread")
+  {
+    uint32_t v = 0;
+    esutils::AtomicBitReferenceWrapper ref(v, 31);
+
+    REQUIRE_FALSE(ref.test());
+    REQUIRE_FALSE(ref.test_and_set());
+    REQUIRE(v == 0x80000000);
+    REQUIRE(ref.test_and_set());
+    ref.flip();
+    REQUIRE(v == 0);
+    ref = true;
+    REQUIRE(ref);
+    REQUIRE(ref.test_and_reset());
+    REQUIRE_FALSE(ref.test_and_reset());
+
+    v = 0xFFFFFFFF;
+    ref.reset();
+    REQUIRE(v == 0x7FFFFFFF);
+    ref.set();
+    REQUIRE(v == 0xFFFFFFFF);
+  }
+
+  SECTION("Volatile integer")
+  {
+    volatile uint8_t v = 0x0F;
+    esutils::AtomicBitReferenceWrapper ref(v, 2);
+    ref.reset();
+    REQUIRE(v == 0x0B);
+    REQUIRE_FALSE(ref.test_and_set(std::memory_order_relaxed));
+    REQUIRE(v == 0x0F);
+  }
+
+  SECTION("Concurrent modifications of the same word")
+  {
+    // Each thread flips its own bit of the shared word, no update must be lost
+    constexpr size_t threadCount = 8;
+    constexpr size_t flips = 10001;
+    uint32_t shared = 0;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; ++t)
+    {
+      threads.emplace_back([&shared, t]() {
+        esutils::AtomicBitReferenceWrapper ref(shared, static_cast<uint8_t>(t));
+        for (size_t i = 0; i < flips; ++i)
+          ref.flip(std::memory_order_relaxed);
+      });
+    }
+    for (auto &thread : threads)
+      thread.join();
+    REQUIRE(shared == 0xFF);
+  }
 }
@@ -47,4 +47,91 @@ TEST_CASE("Bit Slice Reference", "[esutils]")
 
     checkSliceEquality<1, 2, 4, 8, 16, 32>(value1, value2);
   }
+
+  SECTION("Write back")
+  {
+    uint8_t value = 0xA6;
+
+    esutils::BitSliceReference<4, uint8_t, uint8_t>(&value, 0) = 0x3;
+    REQUIRE(value == 0xA3);
+    esutils::BitSliceReference<4, uint8_t, uint8_t>(&value, 1) = 0xF;
+    REQUIRE(value == 0xF3);
+
+    // Bits outside of the slice must be preserved, including when the slice straddles several Underlying
+    std::array<uint8_t, 4> bytes = {0xFF, 0xFF, 0xFF, 0xFF};
+    esutils::BitSliceReference<12, uint16_t, uint8_t>(std::data(bytes), 1) = 0x000;
+    REQUIRE(bytes == std::array<uint8_t, 4>{0xFF, 0x0F, 0x00, 0xFF});
+
+    esutils::BitSliceReference<12, uint16_t, uint8_t>(std::data(bytes), 1) = 0xABC;
+    REQUIRE(bytes == std::array<uint8_t, 4>{0xFF, 0xCF, 0xAB, 0xFF});
+    REQUIRE(esutils::BitSliceReference<12, uint16_t, uint8_t>(std::data(bytes), 1) == 0xABC);
+
+    // Slices relative to a pointer in the middle of the array, with negative offsets
+    esutils::BitSliceReference<4, uint8_t, uint8_t>(std::data(bytes) + 2, -3) = 0x5;
+    REQUIRE(esutils::BitSliceReference<4, uint8_t, const uint8_t>(std::data(bytes) + 2, -3) == 0x5);
+    REQUIRE(esutils::BitSliceReference<4, uint8_t, const uint8_t>(std::data(bytes), 1) == 0x5);
+    REQUIRE(bytes == std::array<uint8_t, 4>{0x5F, 0xCF, 0xAB, 0xFF});
+
+    // Assigning a reference copies the value
+    uint32_t word = 0x12345678;
+    esutils::BitSliceReference<8, uint8_t, uint32_t> lowByte(&word, 0);
+    lowByte = esutils::BitSliceReference<8, uint8_t, uint32_t>(&word, 3);
+    REQUIRE(word == 0x12345612);
+  }
+
+  SECTION("Write and read back on every slice size and position")
+  {
+    std::array<uint32_t, 4> words{};
+    for (size_t offset = 0; offset < 128 / 7; ++offset)
+    {
+      const uint8_t expected = static_cast<uint8_t>((offset * 37) & 0x7F);
+      esutils::BitSliceReference<7, uint8_t, uint32_t>(std::data(words), offset) = expected;
+    }
+    for (size_t offset = 0; offset < 128 / 7; ++offset)
+    {
+      const uint8_t expected = static_cast<uint8_t>((offset * 37) & 0x7F);
+      REQUIRE(esutils::BitSliceReference<7, uint8_t, const uint32_t>(std::data(words), offset) == expected);
+      REQUIRE(esutils::BitSliceReference<7, uint8_t, const uint8_t>(reinterpret_cast<const uint8_t *>(std::data(words)), offset) == expected);
+    }
+  }
+
+  SECTION("Negative offsets on the single Underlying fast path")
+  {
+    std::array<uint32_t, 3> words = {0x33221100, 0x77665544, 0xBBAA9988};
+    const uint32_t *middle = std::data(words) + 1;
+
+    REQUIRE(esutils::BitSliceReference<8, uint8_t, const uint32_t>(middle, -1) == 0x33);
+    REQUIRE(esutils::BitSliceReference<8, uint8_t, const uint32_t>(middle, -4) == 0x00);
+    REQUIRE(esutils::BitSliceReference<16, uint16_t, const uint32_t>(middle, 2) == 0x9988);
+    REQUIRE(esutils::BitSliceReference<4, uint8_t, const uint32_t>(middle, -2) == 0x3);
+    REQUIRE(esutils::BitSliceReference<32, uint32_t, const uint32_t>(middle, -1) == 0x33221100);
+
+    esutils::BitSliceReference<4, uint8_t, uint32_t>(std::data(words) + 2, -7) = 0xD;
+    REQUIRE(words[1] == 0x776655D4);
+  }
+
+  SECTION("Bit field reference")
+  {
+    uint32_t reg = 0xFFFF0000;
+
+    esutils::BitFieldReference<4, 3, uint8_t, uint32_t> field(&reg);
+    REQUIRE(field == 0);
+    field = 5;
+    REQUIRE(reg == 0xFFFF0050);
+    field = 0xFF; // Extra bits are discarded
+    REQUIRE(reg == 0xFFFF0070);
+    REQUIRE(field == 7);
+
+    // Fields of the following Underlying
+    esutils::BitFieldReference<20, 4, uint8_t, uint8_t> byteField(reinterpret_cast<uint8_t *>(&reg));
+    REQUIRE(byteField == (reinterpret_cast<uint8_t *>(&reg)[2] >> 4));
+
+    // Volatile storage, as used for peripheral registers
+    volatile uint16_t vreg = 0x1234;
+    esutils::BitFieldReference<8, 8, uint8_t, volatile uint16_t> high(&vreg);
+    REQUIRE(high == 0x12);
+    high = 0xAB;
+    REQUIRE(vreg == 0xAB34);
+    static_assert(esutils::BitFieldReference<8, 8, uint8_t, volatile uint16_t>::mask == 0xFF00);
+  }
 }
@@ -0,0 +1,201 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/bit_slice_reference.hpp"
+#include "esutils/bit_stream.hpp"
+
+namespace
+{
+  template <esutils::BitOrder order>
+  void checkRoundTrip()
+  {
+    std::mt19937_64 gen(order == esutils::BitOrder::MSB_FIRST ? 1 : 2);
+    std::vector<std::pair<uint64_t, size_t>> fields;
+    for (size_t i = 0; i < 2000; ++i)
+    {
+      const size_t bits = gen() % 65;
+      const uint64_t value = bits == 0 ? 0 : gen() >> (64 - bits);
+      fields.emplace_back(value, bits);
+    }
+
+    std::vector<uint8_t> buffer(2000 * 8 + 1);
+    esutils::BitWriter<order> writer(buffer.data(), buffer.size());
+    size_t totalBits = 0;
+    for (const auto &[value, bits] : fields)
+    {
+      writer.write(value, bits);
+      totalBits += bits;
+    }
+    REQUIRE(writer.bits_written() == totalBits);
+    REQUIRE(writer.flush() == (totalBits + 7) / 8);
+    REQUIRE_FALSE(writer.overflow());
+
+    esutils::BitReader<order> reader(buffer.data(), writer.bytes_written());
+    for (const auto &[value, bits] : fields)
+    {
+      REQUIRE(reader.read(bits) == value);
+    }
+    REQUIRE(reader.bits_consumed() == totalBits);
+    REQUIRE_FALSE(reader.overrun());
+  }
+
+  template <esutils::BitOrder order>
+  void checkCodes()
+  {
+    std::array<uint8_t, 512> buffer{};
+    esutils::BitWriter<order> writer(buffer.data(), buffer.size());
+    const uint64_t values[] = {0, 1, 2, 3, 7, 8, 255, 256, 12345, uint64_t{1} << 40, (uint64_t{1} << 63) - 1};
+    const int64_t signedValues[] = {0, 1, -1, 2, -2, 1000, -1000, INT64_MAX / 2, INT64_MIN / 2};
+    for (uint64_t v : values)
+    {
+      writer.write_exp_golomb(v);
+      writer.write_exp_golomb(v, 3);
+      writer.write_varint(v);
+      writer.write_unary(v % 100);
+    }
+    for (int64_t v : signedValues)
+    {
+      writer.write_signed_exp_golomb(v);
+      writer.write_signed_varint(v);
+    }
+    writer.write_varint(UINT64_MAX);
+    writer.write_signed_varint(INT64_MIN);
+    const size_t size = writer.flush();
+    REQUIRE_FALSE(writer.overflow());
+
+    esutils::BitReader<order> reader(buffer.data(), size);
+    for (uint64_t v : values)
+    {
+      REQUIRE(reader.read_exp_golomb() == v);
+      REQUIRE(reader.read_exp_golomb(3) == v);
+      REQUIRE(reader.read_varint() == v);
+      REQUIRE(reader.read_unary() == v % 100);
+    }
+    for (int64_t v : signedValues)
+    {
+      REQUIRE(reader.read_signed_exp_golomb() == v);
+      REQUIRE(reader.read_signed_varint() == v);
+    }
+    REQUIRE(reader.read_varint() == UINT64_MAX);
+    REQUIRE(reader.read_signed_varint() == INT64_MIN);
+    REQUIRE_FALSE(reader.overrun());
+  }
+}
+
+TEST_CASE("Bit Stream", "[esutils]")
+{
+  SECTION("MSB first layout")
+  {
+    const uint8_t data[] = {0b10110010, 0b01111000};
+    esutils::BitReader reader(data, sizeof(data));
+    REQUIRE(reader.read(1) == 1);
+    REQUIRE(reader.peek(3) == 0b011);
+    REQUIRE(reader.read(3) == 0b011);
+    REQUIRE(reader.read(8) == 0b00100111);
+    REQUIRE(reader.bits_left() == 4);
+    REQUIRE(reader.read(4) == 0b1000);
+    REQUIRE_FALSE(reader.overrun());
+    REQUIRE(reader.read(1) == 0);
+    REQUIRE(reader.overrun());
+  }
+
+  SECTION("LSB first layout matches BitSliceReference")
+  {
+    const uint8_t data[] = {0x5A, 0xC3, 0x7E, 0x19};
+    esutils::BitReader<esutils::BitOrder::LSB_FIRST> reader(data, sizeof(data));
+    for (ptrdiff_t i = 0; i < 10; ++i)
+    {
+      REQUIRE(reader.read(3) == esutils::BitSliceReference<3, uint8_t, const uint8_t>(data, i));
+    }
+  }
+
+  SECTION("H.264 Exp-Golomb codes")
+  {
+    // 1 | 010 | 011 | 00100 | 00111 : ue(v) 0, 1, 2, 3, 6
+    const uint8_t data[] = {0b10100110, 0b01000011, 0b10000000};
+    esutils::BitReader reader(data, sizeof(data));
+    REQUIRE(reader.read_exp_golomb() == 0);
+    REQUIRE(reader.read_exp_golomb() == 1);
+    REQUIRE(reader.read_exp_golomb() == 2);
+    REQUIRE(reader.read_exp_golomb() == 3);
+    REQUIRE(reader.read_exp_golomb() == 6);
+
+    std::array<uint8_t, 3> written{};
+    esutils::BitWriter writer(written.data(), written.size());
+    for (uint64_t v : {0, 1, 2, 3, 6})
+      writer.write_exp_golomb(v);
+    REQUIRE(writer.flush() == 3);
+    REQUIRE(written == std::array<uint8_t, 3>{data[0], data[1], data[2]});
+  }
+
+  SECTION("Skip and align")
+  {
+    std::array<uint8_t, 64> data{};
+    for (size_t i = 0; i < data.size(); ++i)
+      data[i] = static_cast<uint8_t>(i);
+    esutils::BitReader reader(data.data(), data.size());
+    reader.read(3);
+    reader.align();
+    REQUIRE(reader.read(8) == 1);
+    reader.skip(4);
+    reader.skip(8 * 20 + 4);
+    REQUIRE(reader.read(8) == 23);
+    reader.skip(3);
+    REQUIRE(reader.read(5) == (24 & 0x1F));
+    REQUIRE(reader.read(16) == 0x191A);
+  }
+
+  SECTION("Round trip")
+  {
+    checkRoundTrip<esutils::BitOrder::MSB_FIRST>();
+    checkRoundTrip<esutils::BitOrder::LSB_FIRST>();
+    checkCodes<esutils::BitOrder::MSB_FIRST>();
+    checkCodes<esutils::BitOrder::LSB_FIRST>();
+  }
+
+  SECTION("Overflow")
+  {
+    std::array<uint8_t, 2> buffer{};
+    esutils::BitWriter writer(buffer.data(), buffer.size());
+    writer.write(0xABCD, 16);
+    REQUIRE(writer.flush() == 2);
+    REQUIRE_FALSE(writer.overflow());
+    writer.write(1, 1);
+    writer.flush();
+    REQUIRE(writer.overflow());
+    REQUIRE(buffer == std::array<uint8_t, 2>{0xAB, 0xCD});
+  }
+
+  SECTION("Malformed codes")
+  {
+    const uint8_t zeros[16] = {};
+    esutils::BitReader reader(zeros, sizeof(zeros));
+    reader.read_exp_golomb();
+    REQUIRE(reader.overrun());
+
+    const uint8_t continued[12] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00};
+    esutils::BitReader varintReader(continued, sizeof(continued));
+    REQUIRE(varintReader.read_varint() == 0);
+    REQUIRE(varintReader.overrun());
+  }
+}
+
+namespace
+{
+  constexpr uint64_t compileTimeRoundTrip()
+  {
+    uint8_t buffer[8]{};
+    esutils::BitWriter<esutils::BitOrder::LSB_FIRST> writer(buffer, sizeof(buffer));
+    writer.write(0x15, 5);
+    writer.write_exp_golomb(42);
+    writer.flush();
+    esutils::BitReader<esutils::BitOrder::LSB_FIRST> reader(buffer, sizeof(buffer));
+    return reader.read(5) * 1000 + reader.read_exp_golomb();
+  }
+  static_assert(compileTimeRoundTrip() == 21042);
+}
@@ -0,0 +1,87 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/breakpoint_lookup_table.hpp"
+
+namespace
+{
+  constexpr esutils::BreakpointLookUpTable<int, 5> table({0, 10, 15, 40, 100}, {0, 100, 120, 130, 100});
+  static_assert(table(-5) == 0);
+  static_assert(table(0) == 0);
+  static_assert(table(5) == 50);
+  static_assert(table(10) == 100);
+  static_assert(table(14) == 116);
+  static_assert(table(15) == 120);
+  static_assert(table(20) == 122);
+  static_assert(table(70) == 115);
+  static_assert(table(100) == 100);
+  static_assert(table(1000) == 100);
+  static_assert(table.size() == 5);
+}
+
+TEST_CASE("Breakpoint Look Up Table", "[esutils]")
+{
+  SECTION("Deduced from breakpoints and values")
+  {
+    const esutils::BreakpointLookUpTable curve({-1.0, 0.0, 0.5, 2.0}, {4.0, 0.0, 1.0, -2.0});
+    REQUIRE(curve(-1.0) == 4.0);
+    REQUIRE(curve(-0.25) == 1.0);
+    REQUIRE(curve(0.25) == 0.5);
+    REQUIRE(curve(1.0) == 0.0);
+    REQUIRE(curve(2.0) == -2.0);
+    REQUIRE(curve.breakpoint(2) == 0.5);
+    REQUIRE(curve[3] == -2.0);
+  }
+
+  SECTION("Every segment is found")
+  {
+    // Breakpoints at the squares, the curve is y = 2x everywhere
+    constexpr size_t count = 37;
+    int32_t xs[count]{};
+    int32_t ys[count]{};
+    for (size_t i = 0; i < count; ++i)
+    {
+      xs[i] = static_cast<int32_t>(i * i);
+      ys[i] = 2 * xs[i];
+    }
+    const esutils::BreakpointLookUpTable<int32_t, count> doubled(xs, ys);
+    for (int32_t x = 0; x <= xs[count - 1]; ++x)
+    {
+      REQUIRE(doubled(x) == 2 * x);
+    }
+  }
+
+  SECTION("Sensor linearization with breakpoints concentrated on the steep end")
+  {
+    // 1 / x like response of a thermistor divider, sampled on a 12 bits ADC
+    const auto response = [](double adc) { return 1e6 / (adc + 64.0); };
+    const uint16_t breakpoints[] = {0, 32, 64, 128, 256, 512, 1024, 2048, 4095};
+    const esutils::BreakpointLookUpTable<int32_t, 9, uint16_t> linearization(response, breakpoints);
+    size_t segment = 0;
+    for (uint16_t adc = 0; adc <= 4095; ++adc)
+    {
+      if (adc > breakpoints[segment + 1])
+        ++segment;
+      // Same result as an exact interpolation between the rounded breakpoint values
+      const double y0 = std::lround(response(breakpoints[segment]));
+      const double y1 = std::lround(response(breakpoints[segment + 1]));
+      const double expected = y0 + (y1 - y0) * (adc - breakpoints[segment]) / (breakpoints[segment + 1] - breakpoints[segment]);
+      REQUIRE(std::abs(linearization(adc) - expected) <= 0.5 + 1e-9);
+    }
+    REQUIRE(linearization(0) == 15625);
+    REQUIRE(linearization(4095) == static_cast<int32_t>(std::lround(response(4095))));
+  }
+
+  SECTION("Q31 values with large spans")
+  {
+    const esutils::BreakpointLookUpTable<int32_t, 3, int32_t> wide({INT32_MIN, 0, INT32_MAX}, {INT32_MAX, 0, INT32_MAX});
+    REQUIRE(wide(INT32_MIN) == INT32_MAX);
+    REQUIRE(wide(0) == 0);
+    REQUIRE(wide(INT32_MAX) == INT32_MAX);
+    REQUIRE(std::abs(wide(1 << 30) - (1 << 30)) <= 4);
+    REQUIRE(std::abs(wide(-(1 << 30)) - (1 << 30)) <= 4);
+  }
+}
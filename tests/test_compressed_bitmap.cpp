@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/compressed_bitmap.hpp"
+
+namespace
+{
+  std::vector<uint32_t> toVector(const esutils::CompressedBitmap &bitmap)
+  {
+    std::vector<uint32_t> values;
+    for (uint32_t v : bitmap)
+      values.push_back(v);
+    return values;
+  }
+
+  void fill(esutils::CompressedBitmap &bitmap, std::set<uint32_t> &reference, std::mt19937 &rng, size_t count, uint32_t maxValue)
+  {
+    std::uniform_int_distribution<uint32_t> pick(0, maxValue);
+    for (size_t i = 0; i < count; ++i)
+    {
+      const uint32_t v = pick(rng);
+      REQUIRE(bitmap.add(v) == reference.insert(v).second);
+    }
+  }
+}
+
+TEST_CASE("Compressed Bitmap", "[esutils]")
+{
+  SECTION("Basic usage")
+  {
+    esutils::CompressedBitmap bitmap;
+    REQUIRE(bitmap.empty());
+
+    REQUIRE(bitmap.add(7));
+    REQUIRE(bitmap.add(0xFFFFFFFF));
+    REQUIRE(bitmap.add(70000));
+    REQUIRE(bitmap.add(7) == false);
+
+    REQUIRE(bitmap.contains(7));
+    REQUIRE(bitmap.contains(70000));
+    REQUIRE(bitmap.contains(8) == false);
+    REQUIRE(bitmap.cardinality() == 3);
+    REQUIRE(toVector(bitmap) == std::vector<uint32_t>{7, 70000, 0xFFFFFFFF});
+
+    REQUIRE(bitmap.remove(70000));
+    REQUIRE(bitmap.remove(70000) == false);
+    REQUIRE(bitmap.cardinality() == 2);
+  }
+
+  SECTION("Container conversions keep the content")
+  {
+    std::mt19937 rng(1);
+    esutils::CompressedBitmap bitmap;
+    std::set<uint32_t> reference;
+
+    // Dense chunk: goes over the array threshold
+    fill(bitmap, reference, rng, 20000, 0xFFFF);
+    REQUIRE(bitmap.cardinality() == reference.size());
+
+    // Remove most values so the chunk goes back to an array
+    std::vector<uint32_t> values(reference.begin(), reference.end());
+    for (size_t i = 0; i < values.size(); i += 1)
+    {
+      if (i % 10)
+      {
+        REQUIRE(bitmap.remove(values[i]));
+        reference.erase(values[i]);
+      }
+    }
+    REQUIRE(toVector(bitmap) == std::vector<uint32_t>(reference.begin(), reference.end()));
+
+    // Long ranges become run containers
+    bitmap.add_range(100000, 300000);
+    for (uint32_t v = 100000; v <= 300000; ++v)
+      reference.insert(v);
+    const size_t before = bitmap.memory_usage();
+    bitmap.run_optimize();
+    REQUIRE(bitmap.memory_usage() <= before);
+    REQUIRE(bitmap.cardinality() == reference.size());
+    REQUIRE(toVector(bitmap) == std::vector<uint32_t>(reference.begin(), reference.end()));
+
+    // Punch holes in the runs
+    for (uint32_t v = 150000; v < 160000; v += 3)
+    {
+      REQUIRE(bitmap.remove(v));
+      reference.erase(v);
+    }
+    for (uint32_t v = 150001; v < 150100; v += 3)
+    {
+      REQUIRE(bitmap.add(v) == false);
+      REQUIRE(bitmap.add(v - 1));
+      reference.insert(v - 1);
+    }
+    REQUIRE(toVector(bitmap) == std::vector<uint32_t>(reference.begin(), reference.end()));
+  }
+
+  SECTION("Union and intersection")
+  {
+    std::mt19937 rng(2);
+    for (int round = 0; round < 4; ++round)
+    {
+      esutils::CompressedBitmap a, b;
+      std::set<uint32_t> refA, refB;
+      fill(a, refA, rng, 30000, 1 << 18);
+      fill(b, refB, rng, 500, 1 << 20);
+      a.add_range(200000, 270000);
+      b.add_range(260000, 400000);
+      for (uint32_t v = 200000; v <= 270000; ++v)
+        refA.insert(v);
+      for (uint32_t v = 260000; v <= 400000; ++v)
+        refB.insert(v);
+      if (round % 2)
+      {
+        a.run_optimize();
+        b.run_optimize();
+      }
+
+      std::vector<uint32_t> expectedUnion, expectedIntersection;
+      std::set_union(refA.begin(), refA.end(), refB.begin(), refB.end(), std::back_inserter(expectedUnion));
+      std::set_intersection(refA.begin(), refA.end(), refB.begin(), refB.end(), std::back_inserter(expectedIntersection));
+
+      REQUIRE(toVector(a | b) == expectedUnion);
+      REQUIRE(toVector(b | a) == expectedUnion);
+      REQUIRE(toVector(a & b) == expectedIntersection);
+      REQUIRE(toVector(b & a) == expectedIntersection);
+      REQUIRE((a & b).cardinality() == expectedIntersection.size());
+      REQUIRE((a | b) == (b | a));
+    }
+  }
+}
@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/fast_math.hpp"
+
+using esutils::Accuracy;
+
+namespace
+{
+  constexpr double pi = 3.14159265358979323846;
+
+  static_assert(esutils::fast_sin(0.0) == 0.0);
+  static_assert(esutils::fast_sin<Accuracy::HIGH>(pi / 6) > 0.4999999 && esutils::fast_sin<Accuracy::HIGH>(pi / 6) < 0.5000001);
+  static_assert(esutils::sin_q15(0) == 0);
+  static_assert(esutils::sin_q15(0x4000) == 32767);
+  static_assert(esutils::cos_q15(0x8000) == -32767);
+  static_assert(esutils::atan2_cordic(0, 0) == 0);
+  static_assert(esutils::exp2_q16(0) == 65536);
+  static_assert(esutils::exp2_q16(3 << 16) == 8 << 16);
+  static_assert(esutils::log2_q16(1 << 16) == 0);
+  static_assert(esutils::log2_q16(4 << 16) == 2 << 16);
+  static_assert(esutils::log2_q16(0) == INT32_MIN);
+// The floating point approximations are only constexpr with __builtin_bit_cast
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_bit_cast)
+  static_assert(esutils::fast_exp2<Accuracy::HIGH>(10.0f) == 1024.0f);
+  static_assert(esutils::fast_log2(0.25) == -2.0);
+  static_assert(esutils::fast_atan2(1.0, 0.0) == pi / 2);
+#endif
+#endif
+
+  /**
+   * Maximum errors measured against the standard library, published in the documentation of fast_math.hpp
+   */
+  struct Errors
+  {
+    double sin = 0;
+    double cos = 0;
+    double exp2 = 0;
+    double log2 = 0;
+    double invSqrt = 0;
+    double atan2 = 0;
+  };
+
+  template <Accuracy accuracy, typename T>
+  Errors measure()
+  {
+    Errors e;
+    for (int i = -1000000; i <= 1000000; ++i)
+    {
+      const T x = static_cast<T>(i * 0.01);
+      e.sin = std::max(e.sin, std::abs(esutils::fast_sin<accuracy>(x) - std::sin(static_cast<double>(x))));
+      e.cos = std::max(e.cos, std::abs(esutils::fast_cos<accuracy>(x) - std::cos(static_cast<double>(x))));
+    }
+    for (int i = -200000; i <= 200000; ++i)
+    {
+      const T x = static_cast<T>(i * 5e-4);
+      const double ref = std::exp2(static_cast<double>(x));
+      e.exp2 = std::max(e.exp2, std::abs(esutils::fast_exp2<accuracy>(x) - ref) / ref);
+    }
+    for (int i = 1; i <= 400000; ++i)
+    {
+      const T x = static_cast<T>(i * 5e-3);
+      e.log2 = std::max(e.log2, std::abs(esutils::fast_log2<accuracy>(x) - std::log2(static_cast<double>(x))));
+      const T y = static_cast<T>(i * 1.37e-4);
+      const double ref = 1 / std::sqrt(static_cast<double>(y));
+      e.invSqrt = std::max(e.invSqrt, std::abs(esutils::fast_inv_sqrt<accuracy>(y) - ref) / ref);
+    }
+    for (int i = 0; i < 400000; ++i)
+    {
+      const double t = i * (2 * pi / 400000) - pi;
+      const T x = static_cast<T>(std::cos(t) * (1 + i % 7));
+      const T y = static_cast<T>(std::sin(t) * (1 + i % 7));
+      const double ref = std::atan2(static_cast<double>(y), static_cast<double>(x));
+      e.atan2 = std::max(e.atan2, std::abs(esutils::fast_atan2<accuracy>(y, x) - ref));
+    }
+    return e;
+  }
+
+  template <Accuracy accuracy, typename T>
+  void check(double sin, double exp2, double log2, double invSqrt, double atan2)
+  {
+    const Errors e = measure<accuracy, T>();
+    CAPTURE(e.sin, e.cos, e.exp2, e.log2, e.invSqrt, e.atan2);
+    REQUIRE(e.sin < sin);
+    REQUIRE(e.cos < sin);
+    REQUIRE(e.exp2 < exp2);
+    REQUIRE(e.log2 < log2);
+    REQUIRE(e.invSqrt < invSqrt);
+    REQUIRE(e.atan2 < atan2);
+  }
+
+  /**
+   * @return the maximum error of atan2_cordic in LSB for vectors of a given length
+   */
+  template <Accuracy accuracy>
+  long cordic_error(double length)
+  {
+    long maxError = 0;
+    for (int i = 0; i < 100000; ++i)
+    {
+      const double t = i * (2 * pi / 100000) - pi;
+      const int32_t x = static_cast<int32_t>(std::lround(std::cos(t) * length));
+      const int32_t y = static_cast<int32_t>(std::lround(std::sin(t) * length));
+      const double ref = std::atan2(y, x) * 32768 / pi;
+      long error = std::lround(std::abs(esutils::atan2_cordic<accuracy>(y, x) - ref));
+      error = error > 32768 ? 65536 - error : error; // pi and -pi are the same angle
+      maxError = std::max(maxError, error);
+    }
+    return maxError;
+  }
+
+  template <Accuracy accuracy>
+  void check_fixed(long sin, long cordic, double exp2, long log2)
+  {
+    long sinError = 0;
+    for (uint32_t angle = 0; angle < 65536; ++angle)
+    {
+      const double t = angle * (2 * pi / 65536);
+      sinError = std::max(sinError, std::abs(esutils::sin_q15<accuracy>(static_cast<uint16_t>(angle)) - std::lround(32767 * std::sin(t))));
+      sinError = std::max(sinError, std::abs(esutils::cos_q15<accuracy>(static_cast<uint16_t>(angle)) - std::lround(32767 * std::cos(t))));
+    }
+
+    const long cordicError = std::max({cordic_error<accuracy>(100), cordic_error<accuracy>(30000), cordic_error<accuracy>(2e9)});
+
+    // Relative error once the 1 LSB of rounding is removed
+    double exp2Error = 0;
+    for (int32_t x = -16 * 65536; x < 16 * 65536; x += 7)
+    {
+      const double ref = std::exp2(x / 65536.0) * 65536;
+      exp2Error = std::max(exp2Error, (std::abs(esutils::exp2_q16<accuracy>(x) - ref) - 1) / ref);
+    }
+
+    long log2Error = 0;
+    for (uint32_t x = 1; x < 4000000000u; x += (x >> 10) + 1)
+    {
+      const double ref = std::log2(x / 65536.0) * 65536;
+      log2Error = std::max(log2Error, std::lround(std::ceil(std::abs(esutils::log2_q16<accuracy>(x) - ref) - 0.5)));
+    }
+
+    CAPTURE(sinError, cordicError, exp2Error, log2Error);
+    REQUIRE(sinError <= sin);
+    REQUIRE(cordicError <= cordic);
+    REQUIRE(exp2Error < exp2);
+    REQUIRE(log2Error <= log2);
+  }
+}
+
+TEST_CASE("Fast Math", "[esutils]")
+{
+  SECTION("Floating point accuracy tiers")
+  {
+    check<Accuracy::LOW, double>(1.4e-4, 7.5e-5, 1.8e-4, 1.8e-3, 2.3e-4);
+    check<Accuracy::LOW, float>(1.4e-4, 7.5e-5, 1.8e-4, 1.8e-3, 2.3e-4);
+    check<Accuracy::MEDIUM, double>(1.5e-6, 7.5e-8, 4.4e-7, 4.6e-6, 1e-5);
+    check<Accuracy::MEDIUM, float>(1.6e-6, 1.6e-7, 9.4e-7, 4.8e-6, 1.1e-5);
+    check<Accuracy::HIGH, double>(7e-11, 4.1e-11, 7.6e-9, 3.2e-11, 1.1e-7);
+    check<Accuracy::HIGH, float>(1.8e-7, 9.3e-8, 5.5e-7, 1.5e-7, 3.8e-7);
+  }
+
+  SECTION("Fixed point accuracy tiers")
+  {
+    check_fixed<Accuracy::LOW>(5, 82, 7.5e-5, 12);
+    check_fixed<Accuracy::MEDIUM>(2, 6, 7.6e-8, 1);
+    check_fixed<Accuracy::HIGH>(1, 1, 3e-9, 1);
+  }
+
+  SECTION("Special values")
+  {
+    REQUIRE(esutils::fast_atan2(0.0, 0.0) == 0.0);
+    REQUIRE(esutils::fast_atan2(0.0f, -1.0f) == static_cast<float>(pi));
+    REQUIRE(esutils::fast_exp2(1000.0f) > 1e38f);
+    REQUIRE(esutils::fast_exp2(-1000.0f) > 0.0f);
+    REQUIRE(esutils::fast_inv_sqrt<Accuracy::HIGH>(4.0) == Catch::Approx(0.5).epsilon(1e-10));
+    REQUIRE(esutils::atan2_cordic<Accuracy::HIGH>(0, -5) == -32768);
+    REQUIRE(esutils::atan2_cordic<Accuracy::HIGH>(-7, 0) == -16384);
+    REQUIRE(esutils::exp2_q16(16 << 16) == UINT32_MAX);
+    REQUIRE(esutils::exp2_q16(INT32_MIN) == 0);
+    REQUIRE(esutils::exp2_q16(-(17 << 16)) == 0);
+    REQUIRE(esutils::log2_q16(1) == -(16 << 16));
+    REQUIRE(esutils::log2_q16(UINT32_MAX) == 16 << 16);
+  }
+
+  SECTION("Batch variants match the scalar functions")
+  {
+    std::vector<float> in(1000);
+    std::vector<float> other(in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+      in[i] = static_cast<float>(i) * 0.01f + 0.001f;
+      other[i] = 5.0f - static_cast<float>(i) * 0.01f;
+    }
+    std::vector<float> out(in.size());
+
+    esutils::fast_sin(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+      REQUIRE(out[i] == esutils::fast_sin(in[i]));
+    esutils::fast_cos<Accuracy::LOW>(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+      REQUIRE(out[i] == esutils::fast_cos<Accuracy::LOW>(in[i]));
+    esutils::fast_exp2(other.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+      REQUIRE(out[i] == esutils::fast_exp2(other[i]));
+    esutils::fast_log2<Accuracy::HIGH>(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+      REQUIRE(out[i] == esutils::fast_log2<Accuracy::HIGH>(in[i]));
+    esutils::fast_inv_sqrt(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+      REQUIRE(out[i] == esutils::fast_inv_sqrt(in[i]));
+    esutils::fast_atan2(in.data(), other.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+      REQUIRE(out[i] == esutils::fast_atan2(in[i], other[i]));
+
+    std::vector<uint16_t> angles(1000);
+    std::vector<int32_t> fixed(angles.size());
+    for (size_t i = 0; i < angles.size(); ++i)
+    {
+      angles[i] = static_cast<uint16_t>(i * 97);
+      fixed[i] = static_cast<int32_t>(i * 1021) - 300000;
+    }
+    std::vector<int16_t> q15(angles.size());
+    esutils::sin_q15(angles.data(), q15.data(), angles.size());
+    for (size_t i = 0; i < angles.size(); ++i)
+      REQUIRE(q15[i] == esutils::sin_q15(angles[i]));
+    esutils::cos_q15<Accuracy::HIGH>(angles.data(), q15.data(), angles.size());
+    for (size_t i = 0; i < angles.size(); ++i)
+      REQUIRE(q15[i] == esutils::cos_q15<Accuracy::HIGH>(angles[i]));
+    esutils::atan2_cordic(fixed.data(), fixed.data() + 1, q15.data(), angles.size() - 1);
+    for (size_t i = 0; i + 1 < angles.size(); ++i)
+      REQUIRE(q15[i] == esutils::atan2_cordic(fixed[i], fixed[i + 1]));
+
+    std::vector<uint32_t> unsignedOut(fixed.size());
+    esutils::exp2_q16(fixed.data(), unsignedOut.data(), fixed.size());
+    for (size_t i = 0; i < fixed.size(); ++i)
+      REQUIRE(unsignedOut[i] == esutils::exp2_q16(fixed[i]));
+    std::vector<int32_t> signedOut(fixed.size());
+    esutils::log2_q16(unsignedOut.data(), signedOut.data(), fixed.size());
+    for (size_t i = 0; i < fixed.size(); ++i)
+      REQUIRE(signedOut[i] == esutils::log2_q16(unsignedOut[i]));
+  }
+}
@@ -0,0 +1,227 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/filters.hpp"
+
+namespace
+{
+  constexpr double pi = 3.14159265358979323846;
+
+  constexpr int16_t filtered_step()
+  {
+    esutils::FirFilter<int16_t, 4> fir({0.25, 0.25, 0.25, 0.25});
+    int16_t y = 0;
+    for (int i = 0; i < 4; ++i)
+      y = fir.process(16384);
+    return y;
+  }
+  static_assert(filtered_step() == 16384);
+
+  // 2nd order Butterworth low pass filter, cutoff at fs / 10
+  constexpr double lowPass[5] = {0.06745527388907191, 0.13491054777814382, 0.06745527388907191, -1.1429805025399011,
+                                 0.41280159809618877};
+
+  std::vector<double> test_signal(size_t n)
+  {
+    std::vector<double> x(n);
+    for (size_t i = 0; i < n; ++i)
+      x[i] = 0.45 * std::sin(0.05 * static_cast<double>(i)) + 0.3 * std::sin(1.3 * static_cast<double>(i)) +
+             0.2 * std::cos(2.9 * static_cast<double>(i));
+    return x;
+  }
+}
+
+TEST_CASE("Filters", "[esutils]")
+{
+  SECTION("Mirrored delay line")
+  {
+    esutils::MirroredDelayLine<int, 4> delay;
+    for (int i = 1; i <= 6; ++i)
+    {
+      delay.push(i);
+      const int *window = delay.window();
+      for (int j = 0; j < 4; ++j)
+        REQUIRE(window[j] == (i - 3 + j > 0 ? i - 3 + j : 0));
+      REQUIRE(delay[0] == i);
+    }
+    REQUIRE(delay[3] == 3);
+    REQUIRE(delay.size() == 4);
+    delay.clear();
+    REQUIRE(delay[0] == 0);
+  }
+
+  SECTION("FIR filter")
+  {
+    const float h[5] = {0.5f, -0.25f, 0.125f, 0.0625f, -0.03125f};
+    esutils::FirFilter<float, 5> fir(h);
+    REQUIRE(fir.size() == 5);
+    REQUIRE(fir.process(1.0f) == h[0]);
+    for (size_t k = 1; k < 5; ++k)
+      REQUIRE(fir.process(0.0f) == h[k]);
+    REQUIRE(fir.process(0.0f) == 0.0f);
+
+    const std::vector<double> signal = test_signal(1000);
+    std::vector<float> in(signal.begin(), signal.end());
+    std::vector<float> scalar(in.size());
+    std::vector<float> block(in.size());
+    fir.clear();
+    for (size_t i = 0; i < in.size(); ++i)
+      scalar[i] = fir.process(in[i]);
+    fir.clear();
+    // Uneven chunks to cross the internal block boundaries
+    for (size_t start = 0, n = 1; start < in.size(); start += n, n = n * 3 % 101 + 1)
+      fir.process(in.data() + start, block.data() + start, std::min(n, in.size() - start));
+    REQUIRE(block == scalar);
+
+    fir.clear();
+    fir.process(in.data(), in.data(), in.size());
+    REQUIRE(in == scalar);
+  }
+
+  SECTION("Fixed point FIR filters")
+  {
+    constexpr size_t taps = 31;
+    double h[taps];
+    for (size_t k = 0; k < taps; ++k)
+    {
+      // Windowed sinc low pass filter
+      const double t = static_cast<double>(k) - (taps - 1) / 2.0;
+      const double sinc = t == 0 ? 0.25 : std::sin(pi * 0.25 * t) / (pi * t);
+      h[k] = sinc * (0.54 - 0.46 * std::cos(2 * pi * static_cast<double>(k) / (taps - 1)));
+    }
+    esutils::FirFilter<double, taps> reference(h);
+    esutils::FirFilter<int16_t, taps> q15(h);
+    esutils::FirFilter<int32_t, taps> q31(h);
+    REQUIRE(q15[0] == std::lround(h[0] * 32768));
+
+    const std::vector<double> signal = test_signal(2000);
+    std::vector<int16_t> in15(signal.size());
+    std::vector<int32_t> in31(signal.size());
+    for (size_t i = 0; i < signal.size(); ++i)
+    {
+      in15[i] = static_cast<int16_t>(std::lround(signal[i] * 32768));
+      in31[i] = static_cast<int32_t>(std::lround(signal[i] * 2147483648.0));
+    }
+    std::vector<int16_t> out15(signal.size());
+    std::vector<int32_t> out31(signal.size());
+    q15.process(in15.data(), out15.data(), in15.size());
+    q31.process(in31.data(), out31.data(), in31.size());
+    for (size_t i = 0; i < signal.size(); ++i)
+    {
+      const double y = reference.process(signal[i]);
+      // Coefficient quantization: at most taps / 2 LSB
+      REQUIRE(std::abs(out15[i] - y * 32768) <= taps / 2.0 + 1);
+      REQUIRE(std::abs(out31[i] - y * 2147483648.0) <= taps / 2.0 + 1);
+    }
+
+    q15.clear();
+    for (size_t i = 0; i < signal.size(); ++i)
+      REQUIRE(q15.process(in15[i]) == out15[i]);
+  }
+
+  SECTION("Saturation")
+  {
+    esutils::FirFilter<int16_t, 2> fir({0.9, 0.9});
+    REQUIRE(fir.process(30000) == 27000);
+    REQUIRE(fir.process(30000) == INT16_MAX);
+    REQUIRE(fir.process(-32768) == -2491);
+    REQUIRE(fir.process(-32768) == INT16_MIN);
+  }
+
+  SECTION("Biquad filters")
+  {
+    esutils::BiquadFilter<double> reference(lowPass);
+    esutils::BiquadFilter<float> single(lowPass);
+    esutils::BiquadFilter<int16_t> q15(lowPass);
+    esutils::BiquadFilter<int32_t> q31(lowPass);
+
+    // Unit DC gain
+    double y = 0;
+    for (int i = 0; i < 200; ++i)
+      y = reference.process(0.5);
+    REQUIRE(y == Catch::Approx(0.5).epsilon(1e-9));
+    reference.clear();
+
+    const std::vector<double> signal = test_signal(2000);
+    std::vector<int16_t> in15(signal.size());
+    std::vector<int32_t> in31(signal.size());
+    for (size_t i = 0; i < signal.size(); ++i)
+    {
+      in15[i] = static_cast<int16_t>(std::lround(signal[i] * 32768));
+      in31[i] = static_cast<int32_t>(std::lround(signal[i] * 2147483648.0));
+    }
+    std::vector<int16_t> out15(signal.size());
+    std::vector<int32_t> out31(signal.size());
+    q15.process(in15.data(), out15.data(), in15.size());
+    q31.process(in31.data(), out31.data(), in31.size());
+    double maxError15 = 0;
+    double maxError31 = 0;
+    for (size_t i = 0; i < signal.size(); ++i)
+    {
+      const double expected = reference.process(signal[i]);
+      REQUIRE(single.process(static_cast<float>(signal[i])) == Catch::Approx(expected).margin(1e-5));
+      maxError15 = std::max(maxError15, std::abs(out15[i] / 32768.0 - expected));
+      maxError31 = std::max(maxError31, std::abs(out31[i] / 2147483648.0 - expected));
+    }
+    REQUIRE(maxError15 < 20 / 32768.0);
+    REQUIRE(maxError31 < 1e-7);
+  }
+
+  SECTION("Biquad cascade")
+  {
+    const double sections[2][5] = {
+      {lowPass[0], lowPass[1], lowPass[2], lowPass[3], lowPass[4]},
+      {lowPass[0], lowPass[1], lowPass[2], lowPass[3], lowPass[4]},
+    };
+    esutils::BiquadFilter<double, 2> cascade(sections);
+    esutils::BiquadFilter<double> first(lowPass);
+    esutils::BiquadFilter<double> second(lowPass);
+
+    const std::vector<double> signal = test_signal(500);
+    std::vector<double> block(signal.size());
+    cascade.process(signal.data(), block.data(), signal.size());
+    for (size_t i = 0; i < signal.size(); ++i)
+      REQUIRE(block[i] == second.process(first.process(signal[i])));
+
+    cascade.clear();
+    block = signal;
+    cascade.process(block.data(), block.data(), 200);
+    cascade.process(block.data() + 200, block.data() + 200, 300);
+    first.clear();
+    second.clear();
+    for (size_t i = 0; i < signal.size(); ++i)
+      REQUIRE(block[i] == second.process(first.process(signal[i])));
+  }
+
+  SECTION("Moving average")
+  {
+    esutils::MovingAverage<int16_t, 4> average;
+    REQUIRE(average.process(100) == 25);
+    REQUIRE(average.process(100) == 50);
+    REQUIRE(average.process(-100) == 25);
+    REQUIRE(average.process(-100) == 0);
+    REQUIRE(average.process(-100) == -50);
+    REQUIRE(average.process(-102) == -101);
+    REQUIRE(average.sum() == -402);
+
+    esutils::MovingAverage<uint32_t, 3> unsignedAverage;
+    const uint32_t in[5] = {3000000000u, 3000000000u, 3000000000u, 2, 0};
+    uint32_t out[5]{};
+    unsignedAverage.process(in, out, 5);
+    REQUIRE(out[2] == 3000000000u);
+    REQUIRE(out[4] == 1000000001u);
+
+    esutils::MovingAverage<float, 8> floatAverage;
+    float last = 0;
+    for (int i = 0; i < 10000; ++i)
+      last = floatAverage.process(static_cast<float>(i % 8) * 0.1f + 1000.0f);
+    REQUIRE(last == Catch::Approx(1000.35f).epsilon(1e-6));
+    floatAverage.clear();
+    REQUIRE(floatAverage.mean() == 0.0f);
+  }
+}
@@ -0,0 +1,92 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/hierarchical_bitmap.hpp"
+
+namespace
+{
+  template <size_t sz>
+  void checkAgainstReference(std::mt19937 &rng, size_t nbOperations)
+  {
+    esutils::HierarchicalBitmap<sz> bitmap;
+    std::vector<bool> reference(sz, false);
+    std::uniform_int_distribution<size_t> pick(0, sz - 1);
+
+    for (size_t op = 0; op < nbOperations; ++op)
+    {
+      const size_t i = pick(rng);
+      if (rng() % 3) // Favor insertions so that the bitmap fills up a bit
+      {
+        bitmap.set(i);
+        reference[i] = true;
+      }
+      else
+      {
+        bitmap.reset(i);
+        reference[i] = false;
+      }
+    }
+
+    // Walk every set bit with find_first / find_next and compare with the reference
+    size_t expected = 0;
+    while (expected < sz && !reference[expected])
+      ++expected;
+    REQUIRE(bitmap.find_first() == expected);
+
+    for (size_t i = bitmap.find_first(); i != sz; i = bitmap.find_next(i))
+    {
+      REQUIRE(bitmap[i] == true);
+      expected = i + 1;
+      while (expected < sz && !reference[expected])
+        ++expected;
+      REQUIRE(bitmap.find_next(i) == expected);
+    }
+
+    bitmap.clear();
+    REQUIRE(bitmap.none());
+    REQUIRE(bitmap.find_first() == sz);
+  }
+}
+
+TEST_CASE("Hierarchical Bitmap", "[esutils]")
+{
+  SECTION("Basic usage")
+  {
+    esutils::HierarchicalBitmap<4096> bitmap;
+
+    REQUIRE(bitmap.none());
+    REQUIRE(bitmap.find_first() == 4096);
+
+    bitmap.set(4095);
+    REQUIRE(bitmap.find_first() == 4095);
+    REQUIRE(bitmap.find_next(4095) == 4096);
+
+    bitmap.set(130);
+    REQUIRE(bitmap.find_first() == 130);
+    REQUIRE(bitmap.find_next(130) == 4095);
+    REQUIRE(bitmap.find_next(0) == 130);
+
+    bitmap.reset(130);
+    REQUIRE(bitmap[130] == false);
+    REQUIRE(bitmap.find_first() == 4095);
+
+    bitmap.reset(4095);
+    REQUIRE(bitmap.none());
+  }
+
+  SECTION("Sparse and dense occupancy on several level counts")
+  {
+    std::mt19937 rng(42);
+    checkAgainstReference<1>(rng, 4);
+    checkAgainstReference<64>(rng, 50);
+    checkAgainstReference<100>(rng, 50);
+    checkAgainstReference<4096>(rng, 30);
+    checkAgainstReference<5000>(rng, 4000);
+    checkAgainstReference<262144>(rng, 200);
+    checkAgainstReference<262145>(rng, 200);
+  }
+}
@@ -0,0 +1,139 @@
+#include <cstdint>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/instrumentation.hpp"
+#include "esutils/ring_buffer.hpp"
+#include "esutils/static_set.hpp"
+#include "esutils/static_stack.hpp"
+
+namespace
+{
+  // The default policy is an empty base
+  static_assert(sizeof(esutils::StaticStack<uint32_t, 4>) == 5 * sizeof(uint32_t));
+  static_assert(sizeof(esutils::RingBuffer<uint8_t, 200>) == 203);
+
+  // A counter that advances by 3 each time it is read, and wraps around
+  struct FakeCycleCounter
+  {
+    static inline uint16_t value = 0xFFFE;
+
+    static uint16_t now()
+    {
+      const uint16_t current = value;
+      value = static_cast<uint16_t>(value + 3);
+      return current;
+    }
+  };
+
+  // A 64 bits counter whose operations last longer than 2^32 cycles
+  struct LongCycleCounter
+  {
+    static inline uint64_t value = 0;
+
+    static uint64_t now()
+    {
+      const uint64_t current = value;
+      value += uint64_t{5} << 32;
+      return current;
+    }
+  };
+}
+
+TEST_CASE("Instrumentation", "[esutils]")
+{
+  SECTION("No instrumentation")
+  {
+    esutils::StaticStack<int, 2> stack;
+    stack.push(1);
+    const esutils::ContainerSnapshot snapshot = stack.snapshot();
+    REQUIRE(snapshot.capacity == 2);
+    REQUIRE(snapshot.size == 1);
+    REQUIRE(snapshot.highWaterMark == 0);
+    REQUIRE(snapshot.insertions == 0);
+  }
+
+  SECTION("RingBuffer")
+  {
+    esutils::RingBuffer<int, 4, esutils::ContainerStatistics<>> buffer;
+    for (int i = 0; i < 5; ++i)
+      buffer.write(i);
+    buffer.read();
+    buffer.read();
+    buffer.overwrite(5);
+    buffer.overwrite(6);
+    buffer.overwrite(7);
+    const int values[6] = {};
+    buffer.overwrite(values, 2);
+    buffer.overwrite(values, 6);
+    buffer.read(3);
+
+    const esutils::ContainerSnapshot snapshot = buffer.snapshot();
+    REQUIRE(snapshot.capacity == 4);
+    REQUIRE(snapshot.size == 1);
+    REQUIRE(snapshot.highWaterMark == 4);
+    REQUIRE(snapshot.operations == 13);
+    REQUIRE(snapshot.insertions == 4 + 3 + 2);
+    REQUIRE(snapshot.removals == 2 + 3);
+    REQUIRE(snapshot.rejections == 1 + 6);
+    REQUIRE(snapshot.overwrites == 1 + 2);
+    REQUIRE(snapshot.totalCycles == 0);
+
+    buffer.instrumentation().reset();
+    REQUIRE(buffer.snapshot().operations == 0);
+    REQUIRE(buffer.snapshot().highWaterMark == 0);
+    REQUIRE(buffer.snapshot().size == 1);
+  }
+
+  SECTION("StaticStack with timing")
+  {
+    esutils::StaticStack<int, 3, esutils::ContainerStatistics<FakeCycleCounter>> stack;
+    for (int i = 0; i < 4; ++i)
+      stack.push(i);
+    stack.erase(1);
+    stack.erase(7);
+    stack.pop();
+    stack.pop();
+    stack.pop();
+
+    const esutils::ContainerSnapshot snapshot = stack.snapshot();
+    REQUIRE(snapshot.size == 0);
+    REQUIRE(snapshot.highWaterMark == 3);
+    REQUIRE(snapshot.operations == 9);
+    REQUIRE(snapshot.insertions == 3);
+    REQUIRE(snapshot.rejections == 1);
+    REQUIRE(snapshot.removals == 3);
+    // Each operation reads the counter twice, including across its wrap around
+    REQUIRE(snapshot.totalCycles == 9 * 3);
+    REQUIRE(snapshot.maxCycles == 3);
+  }
+
+  SECTION("Operations longer than 32 bits of cycles")
+  {
+    esutils::StaticStack<int, 3, esutils::ContainerStatistics<LongCycleCounter>> stack;
+    stack.push(1);
+    stack.pop();
+
+    const esutils::ContainerSnapshot snapshot = stack.snapshot();
+    REQUIRE(snapshot.totalCycles == uint64_t{10} << 32);
+    REQUIRE(snapshot.maxCycles == uint64_t{5} << 32);
+  }
+
+  SECTION("StaticSet")
+  {
+    esutils::StaticSet<uint16_t, 4, esutils::ContainerStatistics<>> set;
+    for (uint16_t x : {1, 5, 1, 2, 3, 9})
+      set.insert(x);
+    set.erase(5);
+    set.erase(5);
+
+    const esutils::ContainerSnapshot snapshot = set.snapshot();
+    REQUIRE(snapshot.capacity == 4);
+    REQUIRE(snapshot.size == 3);
+    REQUIRE(snapshot.highWaterMark == 4);
+    REQUIRE(snapshot.operations == 8);
+    REQUIRE(snapshot.insertions == 4);
+    REQUIRE(snapshot.rejections == 1);
+    REQUIRE(snapshot.removals == 1);
+  }
+}
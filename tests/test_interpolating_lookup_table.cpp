@@ -0,0 +1,79 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/interpolating_lookup_table.hpp"
+
+namespace
+{
+  constexpr double pi = 3.14159265358979323846;
+
+  constexpr esutils::InterpolatingLookUpTable<int, 4, int> ramp([](double x) { return 3 * x + 1; }, -8, 8);
+  static_assert(ramp(-8) == -23);
+  static_assert(ramp(0) == 1);
+  static_assert(ramp(5) == 16);
+  static_assert(ramp(8) == 25);
+  static_assert(ramp(-100) == -23);
+  static_assert(ramp(100) == 25);
+  static_assert(ramp.size() == 17);
+}
+
+TEST_CASE("Interpolating Look Up Table", "[esutils]")
+{
+  SECTION("Floating point table")
+  {
+    const esutils::InterpolatingLookUpTable<double, 6> sine([](double x) { return std::sin(x); }, 0.0, pi / 2);
+    REQUIRE(sine.xmin() == 0.0);
+    REQUIRE(sine.xmax() == pi / 2);
+    double maxError = 0;
+    for (double x = 0; x <= pi / 2; x += 0.0001)
+    {
+      maxError = std::max(maxError, std::abs(sine(x) - std::sin(x)));
+    }
+    // Linear interpolation error bound: h^2 / 8 * max|f''|
+    REQUIRE(maxError < (pi / 128) * (pi / 128) / 8 + 1e-12);
+    REQUIRE(sine(-1.0) == 0.0);
+    REQUIRE(sine(10.0) == sine[64]);
+  }
+
+  SECTION("Q15 table indexed by a 12 bits ADC reading")
+  {
+    const auto curve = [](double adc) { return 32767.0 * std::sin(adc / 4095.0 * pi / 2); };
+    const esutils::InterpolatingLookUpTable<int16_t, 5, uint16_t> table(curve, 0, 4095);
+    for (uint16_t adc = 0; adc <= 4095; ++adc)
+    {
+      const double h = 4095.0 / 32 * pi / 2 / 4095.0;
+      REQUIRE(std::abs(table(adc) - curve(adc)) <= 32767.0 * h * h / 8 + 1);
+    }
+    REQUIRE(table(0) == 0);
+    REQUIRE(table(4095) == 32767);
+    REQUIRE(table(5000) == 32767);
+  }
+
+  SECTION("Q31 table with a signed floating point input")
+  {
+    const esutils::InterpolatingLookUpTable<int32_t, 8, float> table(
+      [](float x) { return std::ldexp(static_cast<double>(x), 31) * 0.999; }, -1.0f, 1.0f);
+    for (float x = -1.0f; x <= 1.0f; x += 0.001f)
+    {
+      const double expected = std::ldexp(static_cast<double>(x), 31) * 0.999;
+      REQUIRE(std::abs(table(x) - expected) < 2048);
+    }
+    REQUIRE(table(-2.0f) == table[0]);
+    REQUIRE(table(2.0f) == table[256]);
+  }
+
+  SECTION("Exact samples")
+  {
+    const esutils::InterpolatingLookUpTable<uint32_t, 3, int32_t> table([](double x) { return x * x; }, -1000000, 1000000);
+    for (size_t i = 0; i < table.size(); ++i)
+    {
+      const int32_t x = -1000000 + static_cast<int32_t>(i) * 250000;
+      REQUIRE(table(x) == table[i]);
+    }
+    // Halfway between two samples the result is their mean
+    REQUIRE(table(125000) == (table[4] + table[5]) / 2);
+  }
+}
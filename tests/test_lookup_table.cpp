@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/lookup_table.hpp"
+
+namespace
+{
+  constexpr int square(size_t i)
+  {
+    return static_cast<int>(i * i);
+  }
+
+  constexpr esutils::LookUpTable<int, 16> squares(square);
+  static_assert(squares[5] == 25);
+
+  constexpr int offset = 3;
+  constexpr esutils::LookUpTable<int, 8> shifted([](size_t i) { return static_cast<int>(i) + offset; });
+  static_assert(shifted[7] == 10);
+
+  // Smooth curve: a few residual bits are enough to make the table lossless
+  constexpr esutils::DeltaLookUpTable<int16_t, 1024, 32, 4> parabola([](size_t i) { return static_cast<double>(i * i) / 64.0; });
+  static_assert(parabola.max_error() == 0);
+  static_assert(parabola[0] == 0);
+  static_assert(parabola[1000] == 15625);
+  static_assert(parabola.storage_size() < 1024 * sizeof(int16_t) / 2);
+}
+
+TEST_CASE("Look Up Table", "[esutils]")
+{
+  SECTION("Capturing lambda generator")
+  {
+    const double gain = 2.5;
+    const esutils::LookUpTable<double, 10> table([gain](size_t i) { return gain * static_cast<double>(i); });
+    REQUIRE(table[4] == 10.0);
+  }
+
+  SECTION("Lossless delta table")
+  {
+    const auto calibration = [](size_t i) { return 20000.0 * std::sin(static_cast<double>(i) / 8192.0 * 3.14159265358979) - 1000.0; };
+    const esutils::DeltaLookUpTable<int16_t, 8192, 64, 4> table(calibration);
+    REQUIRE(table.size() == 8192);
+    REQUIRE(table.max_error() == 0);
+    for (size_t i = 0; i < table.size(); ++i)
+    {
+      REQUIRE(table[i] == static_cast<int16_t>(std::lround(calibration(i))));
+    }
+    // 4 bits residuals plus one anchor per 64 values
+    REQUIRE(table.storage_size() * 3 < 8192 * sizeof(int16_t));
+  }
+
+  SECTION("Lossy delta table reports its error")
+  {
+    // Noise that residuals of 3 bits can not represent
+    const auto noisy = [](size_t i) { return static_cast<int32_t>((i * 2654435761u) % 23); };
+    const esutils::DeltaLookUpTable<int32_t, 1000, 16, 3> table(noisy);
+    uint64_t maxError = 0;
+    for (size_t i = 0; i < table.size(); ++i)
+    {
+      const int64_t error = static_cast<int64_t>(table[i]) - noisy(i);
+      maxError = std::max<uint64_t>(maxError, static_cast<uint64_t>(std::abs(error)));
+    }
+    REQUIRE(maxError > 0);
+    REQUIRE(table.max_error() == maxError);
+  }
+
+  SECTION("Partial last segment")
+  {
+    const esutils::DeltaLookUpTable<uint8_t, 37, 8, 2> table([](size_t i) { return 250 - 5 * i; });
+    REQUIRE(table.max_error() == 0);
+    for (size_t i = 0; i < 37; ++i)
+    {
+      REQUIRE(table[i] == 250 - 5 * i);
+    }
+  }
+
+  SECTION("Unsigned convex curve")
+  {
+    // The lines are moved below the curve, under 0 for the first segment
+    const auto square = [](size_t i) { return i * i / 8; };
+    const esutils::DeltaLookUpTable<uint16_t, 256, 32, 6> table(square);
+    const esutils::DeltaLookUpTable<int32_t, 256, 32, 6> reference(square);
+    REQUIRE(table.max_error() == reference.max_error());
+    for (size_t i = 0; i < 256; ++i)
+    {
+      REQUIRE(table[i] == reference[i]);
+    }
+  }
+
+  SECTION("Saturated residuals of an unsigned convex curve")
+  {
+    // The saturated residuals leave the first values under the line, below 0: they are clamped instead of wrapped
+    const auto square = [](size_t i) { return i * i * 2 / 32; };
+    const esutils::DeltaLookUpTable<uint8_t, 16, 16, 2> table(square);
+    REQUIRE(table[0] == 0);
+    uint64_t maxError = 0;
+    for (size_t i = 0; i < 16; ++i)
+    {
+      const int64_t error = static_cast<int64_t>(table[i]) - static_cast<int64_t>(square(i));
+      maxError = std::max<uint64_t>(maxError, static_cast<uint64_t>(std::abs(error)));
+    }
+    REQUIRE(maxError > 0);
+    REQUIRE(table.max_error() == maxError);
+  }
+}
+
+TEST_CASE("Look Up Table transform", "[esutils]")
+{
+  SECTION("Byte table of 16 entries")
+  {
+    const esutils::LookUpTable<uint8_t, 16> gamma([](size_t i) { return static_cast<uint8_t>(i * i); });
+    uint8_t in[100];
+    uint8_t out[100];
+    for (size_t i = 0; i < 100; ++i)
+      in[i] = static_cast<uint8_t>((i * 7) % 16);
+    gamma.transform(in, out, 100);
+    for (size_t i = 0; i < 100; ++i)
+      REQUIRE(out[i] == gamma[in[i]]);
+  }
+
+  SECTION("Small byte table")
+  {
+    const esutils::LookUpTable<int8_t, 5> table([](size_t i) { return static_cast<int8_t>(-static_cast<int>(i)); });
+    uint8_t in[37];
+    int8_t out[37];
+    for (size_t i = 0; i < 37; ++i)
+      in[i] = static_cast<uint8_t>(i % 5);
+    table.transform(in, out, 37);
+    for (size_t i = 0; i < 37; ++i)
+      REQUIRE(out[i] == -static_cast<int>(i % 5));
+  }
+
+  SECTION("Gather of 32 and 64 bits values")
+  {
+    const esutils::LookUpTable<float, 4096> companding([](size_t i) { return std::sqrt(static_cast<float>(i)); });
+    const esutils::LookUpTable<uint64_t, 300> wide([](size_t i) { return uint64_t{0x0123456789ABCDEF} * i; });
+    uint16_t in16[1001];
+    uint32_t in32[1001];
+    uint8_t in8[1001];
+    for (size_t i = 0; i < 1001; ++i)
+    {
+      in16[i] = static_cast<uint16_t>((i * 2654435761u) % 4096);
+      in32[i] = in16[i];
+      in8[i] = static_cast<uint8_t>(in16[i]);
+    }
+
+    float out[1001];
+    companding.transform(in16, out, 1001);
+    for (size_t i = 0; i < 1001; ++i)
+      REQUIRE(out[i] == companding[in16[i]]);
+    companding.transform(in32, out, 1001);
+    for (size_t i = 0; i < 1001; ++i)
+      REQUIRE(out[i] == companding[in32[i]]);
+
+    uint64_t outWide[1001];
+    wide.transform(in8, outWide, 1001);
+    for (size_t i = 0; i < 1001; ++i)
+      REQUIRE(outWide[i] == wide[in8[i]]);
+  }
+}
+
+namespace
+{
+  constexpr int transformedSum()
+  {
+    int in[4] = {1, 2, 3, 4};
+    int out[4] = {};
+    squares.transform(in, out, 4);
+    return out[0] + out[1] + out[2] + out[3];
+  }
+  static_assert(transformedSum() == 30);
+}
@@ -0,0 +1,81 @@
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include "esutils/lookup_table_nd.hpp"
+
+namespace
+{
+  // z = 10 * i + j, bilinear interpolation is exact for this plane
+  constexpr esutils::LookUpTable2D<int, 4, 5> plane([](size_t i, size_t j) { return static_cast<int>(10 * i + j); });
+  static_assert(plane.at(0, 0) == 0);
+  static_assert(plane.at(3, 4) == 34);
+  static_assert(plane.data()[1 * 5 + 2] == 12);
+  static_assert(plane.interpolate(1.5, 2.5) == 18);
+  static_assert(plane.interpolate_fixed(uint32_t{0x18000}, uint32_t{0x28000}) == 18);
+  static_assert(plane.interpolate_fixed(-65536, 0) == 0);
+  static_assert(plane.interpolate_fixed(int64_t{-1}, int64_t{1} << 40) == 4);
+  static_assert(plane.interpolate(-3.0, 100.0) == 4);
+  static_assert(plane.size() == 20);
+  static_assert(plane.rank() == 2 && plane.extent(0) == 4 && plane.extent(1) == 5);
+}
+
+TEST_CASE("Look Up Table ND", "[esutils]")
+{
+  SECTION("Bilinear interpolation")
+  {
+    // z = i * j is bilinear, so interpolating it is exact everywhere
+    const esutils::LookUpTable2D<double, 8, 6> table([](size_t i, size_t j) { return static_cast<double>(i * j); });
+    for (double x = 0; x <= 7; x += 0.125)
+    {
+      for (double y = 0; y <= 5; y += 0.25)
+      {
+        REQUIRE(table.interpolate(x, y) == Catch::Approx(x * y));
+        REQUIRE(table.interpolate_fixed(static_cast<uint32_t>(x * 65536), static_cast<uint32_t>(y * 65536)) == Catch::Approx(x * y));
+      }
+    }
+    REQUIRE(table.interpolate(7.0, 5.0) == 35.0);
+    REQUIRE(table.interpolate_fixed(uint32_t{7} << 16, uint32_t{5} << 16) == 35.0);
+  }
+
+  SECTION("Trilinear interpolation of a fixed point map")
+  {
+    const auto f = [](size_t i, size_t j, size_t k) { return 1000.0 * static_cast<double>(i) - 300.0 * static_cast<double>(j * k) + 7.0 * static_cast<double>(k); };
+    const esutils::LookUpTable3D<int32_t, 3, 4, 5> table(f);
+    REQUIRE(table.at(2, 3, 4) == 2000 - 3600 + 28);
+    for (uint32_t x = 0; x <= (2u << 16); x += 0x2000)
+    {
+      for (uint32_t y = 0; y <= (3u << 16); y += 0x4000)
+      {
+        for (uint32_t z = 0; z <= (4u << 16); z += 0x4000)
+        {
+          const double fx = x / 65536.0, fy = y / 65536.0, fz = z / 65536.0;
+          const double expected = 1000.0 * fx - 300.0 * fy * fz + 7.0 * fz;
+          REQUIRE(std::abs(table.interpolate_fixed(x, y, z) - expected) <= 1.0);
+          REQUIRE(std::abs(table.interpolate(fx, fy, fz) - expected) <= 0.5 + 1e-9);
+        }
+      }
+    }
+  }
+
+  SECTION("Batch evaluation")
+  {
+    const esutils::LookUpTable2D<float, 16, 16> table([](size_t i, size_t j) { return std::sin(static_cast<float>(i)) + static_cast<float>(j); });
+    std::vector<float> xs, ys;
+    for (int i = 0; i < 1000; ++i)
+    {
+      xs.push_back(static_cast<float>(i % 97) * 0.16f);
+      ys.push_back(static_cast<float>(i % 89) * 0.17f);
+    }
+    std::vector<float> out(xs.size());
+    table.interpolate_batch(std::array<const float *, 2>{xs.data(), ys.data()}, out.data(), out.size());
+    for (size_t i = 0; i < xs.size(); ++i)
+    {
+      REQUIRE(out[i] == table.interpolate(xs[i], ys[i]));
+    }
+  }
+}
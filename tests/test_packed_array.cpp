@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/packed_array.hpp"
+
+namespace
+{
+  constexpr esutils::PackedArray<12, uint16_t, 8> makeRamp()
+  {
+    esutils::PackedArray<12, uint16_t, 8> ret;
+    for (size_t i = 0; i < ret.size(); ++i)
+    {
+      ret[i] = static_cast<uint16_t>(0x100 * i + i);
+    }
+    return ret;
+  }
+
+  constexpr auto ramp = makeRamp();
+  static_assert(ramp[7] == 0x707);
+  static_assert(ramp.storage_size() == 12);
+}
+
+TEST_CASE("Packed Array", "[esutils]")
+{
+  SECTION("Basic usage")
+  {
+    esutils::PackedArray<12, uint16_t, 100> samples;
+    REQUIRE(samples.size() == 100);
+    REQUIRE(samples.storage_size() == 152);
+
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+      REQUIRE(samples[i] == 0);
+      samples[i] = static_cast<uint16_t>(i * 41);
+    }
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+      REQUIRE(samples[i] == ((i * 41) & 0xFFF));
+    }
+
+    // Neighbouring elements are not affected by writes
+    samples[50] = 0xFFF;
+    REQUIRE(samples[49] == 49 * 41);
+    REQUIRE(samples[51] == 51 * 41);
+  }
+
+  SECTION("Fill")
+  {
+    esutils::PackedArray<10, uint16_t, 33> tenBits;
+    tenBits.fill(0x2AA);
+    REQUIRE(std::all_of(tenBits.cbegin(), tenBits.cend(), [](uint16_t v) { return v == 0x2AA; }));
+
+    esutils::PackedArray<4, uint8_t, 17, uint8_t> nibbles;
+    nibbles.fill(0xC);
+    REQUIRE(std::all_of(nibbles.cbegin(), nibbles.cend(), [](uint8_t v) { return v == 0xC; }));
+  }
+
+  SECTION("Iterators and bulk copy")
+  {
+    std::array<uint16_t, 64> source;
+    std::iota(source.begin(), source.end(), uint16_t{1000});
+
+    esutils::PackedArray<11, uint16_t, 70> packed;
+    packed.copy_from(source.data(), source.size(), 3);
+    REQUIRE(packed[2] == 0);
+    REQUIRE(packed[3] == 1000);
+    REQUIRE(packed[66] == 1063);
+    REQUIRE(packed[67] == 0);
+
+    std::array<uint16_t, 64> destination{};
+    packed.copy_to(destination.data(), destination.size(), 3);
+    REQUIRE(destination == source);
+
+    auto it = packed.begin() + 3;
+    REQUIRE(*it == 1000);
+    REQUIRE(it[10] == 1010);
+    REQUIRE(packed.end() - packed.begin() == 70);
+    *it = 5;
+    REQUIRE(packed[3] == 5);
+
+    esutils::PackedArray<11, uint16_t, 70>::const_iterator cit = it;
+    REQUIRE(*(cit + 1) == 1001);
+    REQUIRE(std::count(packed.cbegin(), packed.cend(), uint16_t{0}) == 6);
+  }
+}
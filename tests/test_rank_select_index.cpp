@@ -0,0 +1,71 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/rank_select_index.hpp"
+
+namespace
+{
+  constexpr esutils::BoolCollection<20> compileTimeCollection(0xF0, 0x0F, 0xFF);
+  constexpr esutils::RankSelectIndex<20> compileTimeIndex(compileTimeCollection);
+
+  // Padding bits of the last byte must be ignored
+  static_assert(compileTimeIndex.count() == 12);
+  static_assert(compileTimeIndex.rank(4) == 4);
+  static_assert(compileTimeIndex.rank(12) == 4);
+  static_assert(compileTimeIndex.select(4) == 12);
+  static_assert(compileTimeIndex.select(12) == 20);
+
+  template <size_t sz, size_t sampleRate>
+  void checkAgainstReference(std::mt19937 &rng, unsigned density)
+  {
+    esutils::BoolCollection<sz> collection;
+    std::vector<size_t> setBits;
+    for (size_t i = 0; i < sz; ++i)
+    {
+      const bool b = rng() % 100 < density;
+      collection[i] = b;
+      if (b)
+        setBits.push_back(i);
+    }
+
+    esutils::RankSelectIndex<sz, sampleRate> index(collection);
+    REQUIRE(index.count() == setBits.size());
+
+    size_t expectedRank = 0;
+    for (size_t i = 0; i <= sz; ++i)
+    {
+      REQUIRE(index.rank(i) == expectedRank);
+      if (i < sz && collection[i])
+        ++expectedRank;
+    }
+
+    for (size_t k = 0; k < setBits.size(); ++k)
+    {
+      REQUIRE(index.select(k) == setBits[k]);
+    }
+    REQUIRE(index.select(setBits.size()) == sz);
+
+    // Incremental update after modifying the end of the collection
+    const size_t modified = sz * 3 / 4;
+    for (size_t i = modified; i < sz; ++i)
+      collection[i] = true;
+    index.update(modified);
+    REQUIRE(index.count() == index.rank(modified) + (sz - modified));
+    REQUIRE(index.select(index.rank(modified)) == modified);
+  }
+}
+
+TEST_CASE("Rank Select Index", "[esutils]")
+{
+  std::mt19937 rng(3);
+  checkAgainstReference<1, 1>(rng, 50);
+  checkAgainstReference<64, 4>(rng, 50);
+  checkAgainstReference<1000, 256>(rng, 2);
+  checkAgainstReference<1000, 16>(rng, 50);
+  checkAgainstReference<5000, 64>(rng, 95);
+  checkAgainstReference<70000, 256>(rng, 10);
+}
@@ -0,0 +1,82 @@
+#include <cstdint>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/register_field.hpp"
+
+namespace
+{
+  // A made up control register: EN (bit 0), MODE (bits 1-3), DIV (bits 8-15), IRQ (bit 31)
+  using En = esutils::RegisterField<0, 1>;
+  using Mode = esutils::RegisterField<1, 3>;
+  using Div = esutils::RegisterField<8, 8>;
+  using Irq = esutils::RegisterField<31, 1>;
+
+  static_assert(Mode::mask == 0x0000000E);
+  static_assert(Div::mask == 0x0000FF00);
+  static_assert((Mode::value(5) | Div::value(0x42) | En::set).mask == 0x0000FF0F);
+  static_assert((Mode::value(5) | Div::value(0x42) | En::set).value == 0x0000420B);
+  static_assert(Mode::value(0xFF).value == Mode::mask);
+  static_assert(Mode::constant<3>().value == 0x6);
+  static_assert(Irq::set.value == 0x80000000);
+  static_assert(Div::extract(0x1234ABCD) == 0xAB);
+
+  template <typename Access>
+  void checkRegister()
+  {
+    volatile uint32_t raw = 0xF0F000F0;
+    esutils::Register<uint32_t, Access> reg(&raw);
+
+    reg.modify(Mode::value(5), Div::value(0x42), En::set);
+    REQUIRE(raw == 0xF0F042FB);
+    REQUIRE(reg.template read<Mode>() == 5);
+    REQUIRE(reg.template read<Div>() == 0x42);
+    REQUIRE(reg.template read<En>() == 1);
+
+    reg.modify(En::cleared);
+    REQUIRE(raw == 0xF0F042FA);
+
+    reg.write(Irq::set, Div::value(0x10));
+    REQUIRE(reg.read() == 0x80001000);
+
+    reg.write(0x12345678);
+    REQUIRE(raw == 0x12345678);
+  }
+}
+
+TEST_CASE("Register Field", "[esutils]")
+{
+  SECTION("Volatile access")
+  {
+    checkRegister<esutils::VolatileAccess>();
+  }
+
+  SECTION("Atomic access")
+  {
+    checkRegister<esutils::AtomicAccess>();
+  }
+
+  SECTION("Single field reference")
+  {
+    volatile uint32_t raw = 0;
+    esutils::Register<uint32_t> reg(&raw);
+
+    reg.field<Div>() = 0x3C;
+    REQUIRE(raw == 0x3C00);
+    REQUIRE(reg.field<Div>() == 0x3C);
+    reg.field<Irq>() = 1;
+    REQUIRE(raw == 0x80003C00);
+  }
+
+  SECTION("Narrow register")
+  {
+    using Low = esutils::RegisterField<0, 4, uint8_t>;
+    using High = esutils::RegisterField<4, 4, uint8_t>;
+
+    volatile uint8_t raw = 0x5A;
+    esutils::Register<uint8_t> reg(&raw);
+    reg.modify(High::value(0xC));
+    REQUIRE(raw == 0xCA);
+    REQUIRE(reg.read<Low>() == 0xA);
+  }
+}
@@ -0,0 +1,123 @@
+#include <cstdint>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/ring_buffer.hpp"
+
+namespace
+{
+  constexpr esutils::RingBuffer<int, 5> make_queue()
+  {
+    esutils::RingBuffer<int, 5> buffer;
+    for (int i = 0; i < 5; ++i)
+      buffer.write(i * 10);
+    buffer.read();
+    buffer.read();
+    buffer.overwrite(50);
+    buffer.overwrite(60);
+    buffer.overwrite(70); // Overwrites 20
+    return buffer;
+  }
+
+  // Needs a rotation of the storage
+  constexpr int sum_contiguous_read()
+  {
+    esutils::RingBuffer<int, 5> buffer = make_queue();
+    const int *data = buffer.read(5);
+    int sum = 0;
+    for (int i = 0; i < 5; ++i)
+      sum += data[i] * (i + 1);
+    return sum;
+  }
+} // namespace
+
+TEST_CASE("RingBuffer", "[esutils]")
+{
+  esutils::RingBuffer<int, 4> buffer;
+  REQUIRE(buffer.capacity() == 4);
+  REQUIRE(buffer.readable() == 0);
+  REQUIRE_FALSE(buffer.read().has_value());
+  REQUIRE(buffer.peek() == nullptr);
+
+  SECTION("Full and empty")
+  {
+    for (int i = 0; i < 4; ++i)
+      REQUIRE(buffer.write(i));
+    REQUIRE_FALSE(buffer.write(4));
+    REQUIRE(buffer.readable() == 4);
+    REQUIRE(buffer.writable() == 0);
+    for (int i = 0; i < 4; ++i)
+      REQUIRE(*buffer.read() == i);
+    REQUIRE(buffer.readable() == 0);
+    REQUIRE_FALSE(buffer.read().has_value());
+  }
+
+  SECTION("Overwrite")
+  {
+    REQUIRE(buffer.overwrite(0) == esutils::RINGBUFFER_STATUS::OK);
+    for (int i = 1; i < 4; ++i)
+      REQUIRE(buffer.overwrite(i) == esutils::RINGBUFFER_STATUS::OK);
+    REQUIRE(buffer.overwrite(4) == esutils::RINGBUFFER_STATUS::DATA_OVERWRITTEN);
+    REQUIRE(buffer.readable() == 4);
+    REQUIRE(*buffer.peek() == 1);
+
+    const int values[3] = {5, 6, 7};
+    REQUIRE(buffer.overwrite(values, 3) == esutils::RINGBUFFER_STATUS::DATA_OVERWRITTEN);
+    REQUIRE(buffer.readable() == 4);
+    REQUIRE(*buffer.read() == 4);
+    REQUIRE(buffer.overwrite(values, 1) == esutils::RINGBUFFER_STATUS::OK);
+    REQUIRE(buffer.overwrite(values, 5) ==
+            (esutils::RINGBUFFER_STATUS::NO_DATA_WRITTEN | esutils::RINGBUFFER_STATUS::NOT_ENOUGH_SPACE));
+    for (int expected : {5, 6, 7, 5})
+      REQUIRE(*buffer.read() == expected);
+  }
+
+  SECTION("Contiguous read")
+  {
+    for (int i = 0; i < 3; ++i)
+      buffer.write(i);
+    buffer.read();
+    buffer.write(3);
+    buffer.write(4);
+    REQUIRE(buffer.read(5) == nullptr);
+
+    // The readable elements wrap around the end of the storage
+    int *data = buffer.read(3);
+    REQUIRE(data != nullptr);
+    REQUIRE(data[0] == 1);
+    REQUIRE(data[1] == 2);
+    REQUIRE(data[2] == 3);
+    REQUIRE(buffer.readable() == 1);
+    REQUIRE(buffer.write(5));
+    data = buffer.read(2);
+    REQUIRE(data[0] == 4);
+    REQUIRE(data[1] == 5);
+    REQUIRE(buffer.readable() == 0);
+
+    // Rotates the storage to return a contiguous chunk
+    for (int i = 6; i < 10; ++i)
+      REQUIRE(buffer.write(i));
+    data = buffer.read(4);
+    for (int i = 0; i < 4; ++i)
+      REQUIRE(data[i] == 6 + i);
+    REQUIRE(buffer.write(10));
+    REQUIRE(*buffer.read() == 10);
+  }
+
+  SECTION("Compile time")
+  {
+    static constexpr esutils::RingBuffer<int, 5> queue = make_queue();
+    static_assert(queue.capacity() == 5);
+    static_assert(queue.readable() == 5 && queue.writable() == 0);
+    static_assert(*queue.peek() == 30);
+    static_assert(queue[0] == 30 && queue[4] == 70);
+    static_assert(sum_contiguous_read() == 30 + 2 * 40 + 3 * 50 + 4 * 60 + 5 * 70);
+
+    // A copy of the precomputed buffer is usable as is
+    esutils::RingBuffer<int, 5> copy = queue;
+    for (int expected : {30, 40, 50, 60, 70})
+      REQUIRE(*copy.read() == expected);
+    REQUIRE(copy.write(80));
+    REQUIRE(*copy.read() == 80);
+  }
+}
@@ -0,0 +1,140 @@
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <random>
+#include <string>
+#include <utility>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/static_lru_map.hpp"
+
+TEST_CASE("StaticLruMap", "[esutils]")
+{
+  SECTION("Eviction order")
+  {
+    esutils::StaticLruMap<uint32_t, int, 3> cache;
+    REQUIRE(cache.capacity() == 3);
+    REQUIRE(cache.least_recent() == nullptr);
+    REQUIRE(cache.get(1) == nullptr);
+
+    REQUIRE(cache.put(1, 10));
+    REQUIRE(cache.put(2, 20));
+    REQUIRE(cache.put(3, 30));
+    REQUIRE(*cache.least_recent() == 1);
+    REQUIRE(*cache.get(1) == 10);
+    REQUIRE(*cache.least_recent() == 2);
+
+    // 2 is the least recently used entry
+    REQUIRE(cache.put(4, 40));
+    REQUIRE(cache.size() == 3);
+    REQUIRE_FALSE(cache.contains(2));
+    REQUIRE(cache.evictions() == 1);
+
+    // peek does not change the order
+    REQUIRE(*cache.peek(3) == 30);
+    REQUIRE_FALSE(cache.put(3, 31));
+    REQUIRE(cache.put(5, 50));
+    REQUIRE_FALSE(cache.contains(1));
+    REQUIRE(*cache.peek(3) == 31);
+
+    REQUIRE(cache.hits() == 1);
+    REQUIRE(cache.misses() == 1);
+    cache.reset_statistics();
+    REQUIRE(cache.hits() + cache.misses() + cache.evictions() == 0);
+
+    REQUIRE(cache.erase(4));
+    REQUIRE_FALSE(cache.erase(4));
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.put(6, 60));
+    REQUIRE(cache.evictions() == 0);
+    REQUIRE(*cache.least_recent() == 3);
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE_FALSE(cache.contains(5));
+    REQUIRE(cache.put(7, 70));
+    REQUIRE(*cache.get(7) == 70);
+  }
+
+  SECTION("Single entry")
+  {
+    esutils::StaticLruMap<std::string, std::string, 1> cache;
+    REQUIRE(cache.put("a", "alpha"));
+    REQUIRE(cache.put("b", "beta"));
+    REQUIRE(cache.get("a") == nullptr);
+    REQUIRE(*cache.get("b") == "beta");
+  }
+
+  SECTION("Random operations")
+  {
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<uint32_t> key(0, 400);
+    esutils::StaticLruMap<uint32_t, uint32_t, 200> cache;
+    // Most recently used first
+    std::list<std::pair<uint32_t, uint32_t>> reference;
+    const auto find = [&](uint32_t k) {
+      for (auto it = reference.begin(); it != reference.end(); ++it)
+        if (it->first == k)
+          return it;
+      return reference.end();
+    };
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t evictions = 0;
+
+    for (uint32_t i = 0; i < 50000; ++i)
+    {
+      const uint32_t k = key(rng);
+      const auto it = find(k);
+      switch (rng() % 4)
+      {
+      case 0:
+      case 1:
+      {
+        const uint32_t *value = cache.get(k);
+        REQUIRE((value != nullptr) == (it != reference.end()));
+        if (value)
+        {
+          REQUIRE(*value == it->second);
+          reference.splice(reference.begin(), reference, it);
+          ++hits;
+        }
+        else
+        {
+          ++misses;
+        }
+        break;
+      }
+      case 2:
+        REQUIRE(cache.put(k, i) == (it == reference.end()));
+        if (it != reference.end())
+        {
+          reference.erase(it);
+        }
+        else if (reference.size() == 200)
+        {
+          reference.pop_back();
+          ++evictions;
+        }
+        reference.emplace_front(k, i);
+        break;
+      default:
+        REQUIRE(cache.erase(k) == (it != reference.end()));
+        if (it != reference.end())
+          reference.erase(it);
+        break;
+      }
+
+      REQUIRE(cache.size() == reference.size());
+      if (!reference.empty())
+        REQUIRE(*cache.least_recent() == reference.back().first);
+    }
+    REQUIRE(cache.hits() == hits);
+    REQUIRE(cache.misses() == misses);
+    REQUIRE(cache.evictions() == evictions);
+    REQUIRE(evictions > 0);
+    for (const auto &[k, v] : reference)
+      REQUIRE(*cache.peek(k) == v);
+  }
+}
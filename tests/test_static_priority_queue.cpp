@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/static_priority_queue.hpp"
+
+TEST_CASE("StaticPriorityQueue", "[esutils]")
+{
+  SECTION("Push and pop")
+  {
+    esutils::StaticPriorityQueue<int, 8> queue;
+    REQUIRE(queue.capacity() == 8);
+    REQUIRE(queue.empty());
+    REQUIRE(queue.top() == nullptr);
+    REQUIRE(queue.top_handle() == queue.INVALID_HANDLE);
+    REQUIRE_FALSE(queue.pop().has_value());
+
+    for (int x : {5, 1, 9, 3, 7, 9, 0, 4})
+      REQUIRE(queue.push(x) != queue.INVALID_HANDLE);
+    REQUIRE(queue.push(2) == queue.INVALID_HANDLE);
+    REQUIRE(queue.size() == 8);
+    REQUIRE(*queue.top() == 9);
+    for (int expected : {9, 9, 7, 5, 4, 3, 1, 0})
+      REQUIRE(*queue.pop() == expected);
+    REQUIRE(queue.empty());
+  }
+
+  SECTION("Handles")
+  {
+    esutils::StaticPriorityQueue<uint32_t, 16, std::greater<uint32_t>> deadlines;
+    const auto a = deadlines.push(100);
+    const auto b = deadlines.push(50);
+    const auto c = deadlines.push(200);
+    REQUIRE(deadlines.top_handle() == b);
+    REQUIRE(*deadlines.get(a) == 100);
+
+    // Decrease-key and increase-key
+    REQUIRE(deadlines.update(c, 10));
+    REQUIRE(deadlines.top_handle() == c);
+    REQUIRE(deadlines.update(c, 300));
+    REQUIRE(deadlines.top_handle() == b);
+
+    REQUIRE(deadlines.erase(b));
+    REQUIRE_FALSE(deadlines.contains(b));
+    REQUIRE(deadlines.get(b) == nullptr);
+    REQUIRE_FALSE(deadlines.erase(b));
+    REQUIRE_FALSE(deadlines.update(b, 1));
+    REQUIRE(*deadlines.top() == 100);
+
+    // The slot of a released handle is reused under a new handle, the old one stays stale
+    const auto d = deadlines.push(400);
+    REQUIRE(d != b);
+    REQUIRE_FALSE(deadlines.contains(b));
+    REQUIRE_FALSE(deadlines.erase(b));
+    REQUIRE(*deadlines.pop() == 100);
+    REQUIRE_FALSE(deadlines.contains(a));
+    REQUIRE(deadlines.contains(c));
+    REQUIRE(deadlines.contains(d));
+
+    deadlines.clear();
+    REQUIRE(deadlines.empty());
+    REQUIRE_FALSE(deadlines.contains(c));
+    REQUIRE_FALSE(deadlines.contains(d));
+    const auto e = deadlines.push(1);
+    REQUIRE(e != c);
+    REQUIRE(e != d);
+    REQUIRE(deadlines.contains(e));
+  }
+
+  SECTION("Stale handle after pop")
+  {
+    esutils::StaticPriorityQueue<int, 4> queue;
+    const auto first = queue.push(5);
+    REQUIRE(*queue.pop() == 5);
+    const auto second = queue.push(7);
+    REQUIRE_FALSE(queue.erase(first));
+    REQUIRE_FALSE(queue.update(first, 9));
+    REQUIRE(queue.get(first) == nullptr);
+    REQUIRE(*queue.get(second) == 7);
+    REQUIRE(queue.size() == 1);
+  }
+
+  SECTION("Random operations")
+  {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> value(-500, 500);
+    esutils::StaticPriorityQueue<int, 300> queue;
+    std::map<decltype(queue)::handle_t, int> reference;
+
+    for (int i = 0; i < 100000; ++i)
+    {
+      const int operation = static_cast<int>(rng() % 10);
+      if (operation < 4)
+      {
+        const int x = value(rng);
+        const auto handle = queue.push(x);
+        if (reference.size() == 300)
+        {
+          REQUIRE(handle == queue.INVALID_HANDLE);
+        }
+        else
+        {
+          REQUIRE(reference.count(handle) == 0);
+          reference[handle] = x;
+        }
+      }
+      else if (operation < 6)
+      {
+        const auto popped = queue.pop();
+        REQUIRE(popped.has_value() == !reference.empty());
+        if (popped)
+        {
+          const auto top = std::max_element(reference.begin(), reference.end(),
+                                            [](const auto &lhs, const auto &rhs) { return lhs.second < rhs.second; });
+          REQUIRE(*popped == top->second);
+          // Equal values may leave in any order
+          for (auto it = reference.begin(); it != reference.end(); ++it)
+          {
+            if (it->second == *popped && !queue.contains(it->first))
+            {
+              reference.erase(it);
+              break;
+            }
+          }
+        }
+      }
+      else if (!reference.empty())
+      {
+        auto it = reference.begin();
+        std::advance(it, rng() % reference.size());
+        if (operation < 9)
+        {
+          it->second = value(rng);
+          REQUIRE(queue.update(it->first, it->second));
+        }
+        else
+        {
+          REQUIRE(queue.erase(it->first));
+          reference.erase(it);
+        }
+      }
+
+      REQUIRE(queue.size() == reference.size());
+      if (i % 101 == 0)
+      {
+        for (const auto &[handle, x] : reference)
+          REQUIRE(*queue.get(handle) == x);
+      }
+    }
+
+    // Draining gives a sorted sequence
+    std::vector<int> drained;
+    while (const auto x = queue.pop())
+      drained.push_back(*x);
+    REQUIRE(std::is_sorted(drained.rbegin(), drained.rend()));
+    REQUIRE(drained.size() == reference.size());
+  }
+}
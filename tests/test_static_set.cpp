@@ -0,0 +1,130 @@
+#include <cstdint>
+#include <random>
+#include <set>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/static_set.hpp"
+
+namespace
+{
+  template <uint16_t cty>
+  constexpr esutils::StaticSet<uint16_t, cty> make_set()
+  {
+    esutils::StaticSet<uint16_t, cty> set;
+    // Multiples of the capacity share their index, which forces chaining and forwarding
+    for (uint16_t i = 0; i < cty; ++i)
+      set.insert(static_cast<uint16_t>(i % 2 ? i * cty : i + 3));
+    for (uint16_t i = 0; i < cty; i += 4)
+      set.erase(static_cast<uint16_t>(i % 2 ? i * cty : i + 3));
+    return set;
+  }
+
+  template <typename Set>
+  constexpr bool contains(const Set &set, uint16_t value)
+  {
+    return set.find(value) != set.end();
+  }
+
+  template <uint16_t cty>
+  void check_against_std_set(uint16_t range, uint32_t seed)
+  {
+    esutils::StaticSet<uint16_t, cty> set;
+    std::set<uint16_t> reference;
+    std::mt19937 rng(seed);
+    for (int i = 0; i < 5000; ++i)
+    {
+      // Keys biased towards a few indices to build long chains
+      const uint16_t value = static_cast<uint16_t>(rng() % 4 ? rng() % range : (rng() % 8) * cty + rng() % 2);
+      if (rng() % 2)
+      {
+        // A full set rejects any insertion, even of an element it contains
+        const bool room = reference.size() < cty;
+        if (room)
+          reference.insert(value);
+        REQUIRE((set.insert(value) != set.end()) == room);
+      }
+      else
+        REQUIRE(set.erase(value) == (reference.erase(value) != 0));
+      REQUIRE(set.size() == reference.size());
+      size_t mismatches = 0;
+      for (uint16_t v = 0; v < range; ++v)
+        mismatches += contains(set, v) != (reference.count(v) != 0);
+      REQUIRE(mismatches == 0);
+    }
+    size_t iterated = 0;
+    for (uint16_t value : set)
+    {
+      REQUIRE(reference.count(value));
+      ++iterated;
+    }
+    REQUIRE(iterated == reference.size());
+  }
+} // namespace
+
+TEST_CASE("StaticSet", "[esutils]")
+{
+  esutils::StaticSet<uint16_t, 8> set;
+  REQUIRE(set.capacity() == 8);
+  REQUIRE(set.size() == 0);
+  REQUIRE(set.begin() == set.end());
+
+  SECTION("Insert, find and erase")
+  {
+    for (uint16_t i = 0; i < 4; ++i)
+      REQUIRE(set.insert(i * 8) != set.end());
+    REQUIRE(*set.insert(16) == 16);
+    REQUIRE(set.size() == 4);
+    for (uint16_t i = 4; i < 8; ++i)
+      REQUIRE(set.insert(i * 8) != set.end());
+    REQUIRE(set.insert(1) == set.end());
+    REQUIRE(set.size() == 8);
+    REQUIRE(set.erase(0));
+    REQUIRE_FALSE(set.erase(0));
+    REQUIRE(set.erase(32));
+    REQUIRE(set.size() == 6);
+    for (uint16_t i = 0; i < 8; ++i)
+      REQUIRE(contains(set, i * 8) == (i != 0 && i != 4));
+    REQUIRE(set.insert(1) != set.end());
+    REQUIRE(contains(set, 1));
+  }
+
+  SECTION("Clear")
+  {
+    for (uint16_t i = 0; i < 8; ++i)
+      set.insert(i * 3);
+    set.clear();
+    REQUIRE(set.size() == 0);
+    REQUIRE(set.begin() == set.end());
+    REQUIRE_FALSE(contains(set, 3));
+    REQUIRE(set.insert(3) != set.end());
+    REQUIRE(contains(set, 3));
+  }
+
+  SECTION("Against std::set")
+  {
+    check_against_std_set<16>(160, 1);
+    check_against_std_set<24>(256, 2);
+    check_against_std_set<64>(600, 3);
+  }
+
+  SECTION("Compile time")
+  {
+    static constexpr auto powerOfTwo = make_set<16>();
+    static_assert(powerOfTwo.size() == 12);
+    static_assert(contains(powerOfTwo, 2 + 3) && !contains(powerOfTwo, 4 + 3) && contains(powerOfTwo, 1 * 16));
+    static_assert(contains(powerOfTwo, 15 * 16) && !contains(powerOfTwo, 12 + 3) && contains(powerOfTwo, 14 + 3));
+
+    static constexpr auto other = make_set<12>();
+    static_assert(other.size() == 9);
+    static_assert(contains(other, 11 * 12) && !contains(other, 8 + 3) && contains(other, 10 + 3));
+
+    // A copy of the precomputed set is usable as is
+    auto copy = powerOfTwo;
+    REQUIRE(copy.insert(7) != copy.end());
+    REQUIRE(copy.erase(1 * 16));
+    REQUIRE(copy.size() == 12);
+    REQUIRE(contains(copy, 7));
+    REQUIRE_FALSE(contains(copy, 1 * 16));
+  }
+}
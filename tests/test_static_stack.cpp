@@ -0,0 +1,78 @@
+#include <cstdint>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/static_stack.hpp"
+
+namespace
+{
+  constexpr esutils::StaticStack<uint16_t, 8> make_stack()
+  {
+    esutils::StaticStack<uint16_t, 8> stack;
+    for (uint16_t i = 1; i <= 8; ++i)
+      stack.push(i * i);
+    stack.pop();
+    stack.erase(4);
+    return stack;
+  }
+
+  constexpr uint32_t sum(const esutils::StaticStack<uint16_t, 8> &stack)
+  {
+    uint32_t total = 0;
+    for (uint16_t value : stack)
+      total += value;
+    return total;
+  }
+} // namespace
+
+TEST_CASE("StaticStack", "[esutils]")
+{
+  esutils::StaticStack<int, 4> stack;
+  REQUIRE(stack.capacity() == 4);
+  REQUIRE(stack.size() == 0);
+  REQUIRE_FALSE(stack.pop().has_value());
+
+  SECTION("Push and pop")
+  {
+    for (int i = 0; i < 4; ++i)
+      REQUIRE(stack.push(i));
+    REQUIRE_FALSE(stack.push(4));
+    REQUIRE(stack.size() == 4);
+    for (int i = 3; i >= 0; --i)
+      REQUIRE(*stack.pop() == i);
+    REQUIRE(stack.size() == 0);
+  }
+
+  SECTION("Find and erase")
+  {
+    for (int i = 0; i < 4; ++i)
+      stack.push(i * 10);
+    REQUIRE(stack.find(20) == stack.begin() + 2);
+    REQUIRE(stack.find(25) == nullptr);
+    REQUIRE(stack.erase(10));
+    REQUIRE_FALSE(stack.erase(10));
+    REQUIRE(stack.size() == 3);
+    REQUIRE(stack.find(20) == stack.begin() + 1);
+    REQUIRE(*stack.pop() == 30);
+    REQUIRE(*stack.pop() == 20);
+    REQUIRE(*stack.pop() == 0);
+  }
+
+  SECTION("Compile time")
+  {
+    static constexpr esutils::StaticStack<uint16_t, 8> squares = make_stack();
+    static_assert(squares.capacity() == 8);
+    static_assert(squares.size() == 6);
+    static_assert(*squares.find(9) == 9 && squares.find(4) == nullptr && squares.find(64) == nullptr);
+    static_assert(squares.begin()[1] == 9 && squares.end()[-1] == 49);
+    static_assert(sum(squares) == 1 + 9 + 16 + 25 + 36 + 49);
+
+    // A copy of the precomputed stack is usable as is
+    esutils::StaticStack<uint16_t, 8> copy = squares;
+    REQUIRE(copy.push(100));
+    REQUIRE(copy.push(121));
+    REQUIRE_FALSE(copy.push(144));
+    REQUIRE(*copy.pop() == 121);
+    REQUIRE(sum(copy) == sum(squares) + 100);
+  }
+}
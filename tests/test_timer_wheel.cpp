@@ -0,0 +1,171 @@
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/timer_wheel.hpp"
+
+TEST_CASE("TimerWheel", "[esutils]")
+{
+  SECTION("Start, cancel and expire")
+  {
+    esutils::TimerWheel<int, 4, 2> wheel;
+    using handle_t = decltype(wheel)::handle_t;
+    REQUIRE(wheel.max_delay() == 4095);
+    REQUIRE(wheel.capacity() == 4);
+
+    const auto a = wheel.start(10, 1);
+    const auto b = wheel.start(100, 2);
+    const auto c = wheel.start(4095, 3);
+    REQUIRE(wheel.start(4096, 4) == wheel.INVALID_HANDLE);
+    REQUIRE(wheel.size() == 3);
+    REQUIRE(wheel.remaining(b) == 100);
+    REQUIRE(*wheel.get(c) == 3);
+
+    std::vector<int> fired;
+    const auto record = [&](handle_t, int value) { fired.push_back(value); };
+    REQUIRE(wheel.advance(9, record) == 0);
+    REQUIRE(wheel.advance(1, record) == 1);
+    REQUIRE(fired == std::vector<int>{1});
+    REQUIRE_FALSE(wheel.active(a));
+    REQUIRE(wheel.get(a) == nullptr);
+    REQUIRE_FALSE(wheel.cancel(a));
+
+    REQUIRE(wheel.cancel(b));
+    REQUIRE_FALSE(wheel.active(b));
+    REQUIRE(wheel.advance(4084, record) == 0);
+    REQUIRE(wheel.remaining(c) == 1);
+    REQUIRE(wheel.advance(1000, record) == 1);
+    REQUIRE(fired == std::vector<int>{1, 3});
+    REQUIRE(wheel.now() == 5094);
+    REQUIRE(wheel.size() == 0);
+
+    // A delay of 0 expires during the next tick
+    wheel.start(0, 5);
+    REQUIRE(wheel.advance(1, record) == 1);
+
+    wheel.start(5, 6);
+    wheel.start(500, 7);
+    wheel.clear();
+    REQUIRE(wheel.size() == 0);
+    REQUIRE(wheel.advance(1000, record) == 0);
+    REQUIRE(fired.size() == 3);
+  }
+
+  SECTION("Periodic timer restarted from the callback")
+  {
+    esutils::TimerWheel<uint32_t, 2> wheel;
+    using handle_t = decltype(wheel)::handle_t;
+    std::vector<uint32_t> ticks;
+    wheel.start(7, 7);
+    const auto restart = [&](handle_t, uint32_t period) {
+      ticks.push_back(wheel.now());
+      wheel.start(period, period);
+    };
+    wheel.advance(30, restart);
+    REQUIRE(ticks == std::vector<uint32_t>{7, 14, 21, 28});
+  }
+
+  SECTION("Stale handle after expiry")
+  {
+    esutils::TimerWheel<int, 4> wheel;
+    using handle_t = decltype(wheel)::handle_t;
+    const auto expired = wheel.start(5, 1);
+    handle_t fired = wheel.INVALID_HANDLE;
+    REQUIRE(wheel.advance(5, [&](handle_t handle, int) { fired = handle; }) == 1);
+    REQUIRE(fired == expired);
+
+    // The node of the expired timer runs the next one, the old handle must not reach it
+    const auto running = wheel.start(100, 2);
+    REQUIRE(running != expired);
+    REQUIRE_FALSE(wheel.active(expired));
+    REQUIRE(wheel.get(expired) == nullptr);
+    REQUIRE(wheel.remaining(expired) == 0);
+    REQUIRE_FALSE(wheel.cancel(expired));
+    REQUIRE(wheel.active(running));
+    REQUIRE(wheel.remaining(running) == 100);
+
+    REQUIRE(wheel.cancel(running));
+    const auto restarted = wheel.start(10, 3);
+    REQUIRE_FALSE(wheel.cancel(running));
+    REQUIRE(*wheel.get(restarted) == 3);
+    wheel.clear();
+    REQUIRE_FALSE(wheel.active(restarted));
+    REQUIRE(wheel.get(wheel.start(1, 4)) != nullptr);
+  }
+
+  SECTION("Random operations")
+  {
+    std::mt19937 rng(5);
+    esutils::TimerWheel<uint32_t, 500, 3> wheel;
+    using handle_t = decltype(wheel)::handle_t;
+    // Starts close to the wrap around of the ticks
+    wheel.advance(0xFFFF0000u, [](handle_t, uint32_t) {});
+
+    std::map<handle_t, uint64_t> expiries;
+    uint64_t now = 0xFFFF0000u;
+    uint32_t id = 0;
+    std::map<uint32_t, uint64_t> ids;
+
+    for (int i = 0; i < 20000; ++i)
+    {
+      const uint32_t operation = rng() % 8;
+      if (operation < 4)
+      {
+        // Mostly short timeouts with a few long ones
+        const uint32_t delay = 1 + (rng() % 4 == 0 ? rng() % wheel.max_delay() : rng() % 300);
+        const auto handle = wheel.start(delay, id);
+        if (expiries.size() == 500)
+        {
+          REQUIRE(handle == wheel.INVALID_HANDLE);
+          continue;
+        }
+        REQUIRE(expiries.count(handle) == 0);
+        expiries[handle] = now + delay;
+        ids[id++] = now + delay;
+      }
+      else if (operation < 6 && !expiries.empty())
+      {
+        auto it = expiries.begin();
+        std::advance(it, rng() % expiries.size());
+        ids.erase(*wheel.get(it->first));
+        REQUIRE(wheel.cancel(it->first));
+        expiries.erase(it);
+      }
+      else
+      {
+        const uint32_t ticks = rng() % 4 == 0 ? rng() % 5000 : rng() % 50;
+        uint64_t last = now;
+        const size_t running = expiries.size();
+        const size_t expired = wheel.advance(ticks, [&](handle_t handle, uint32_t value) {
+          const uint32_t elapsed = wheel.now() - static_cast<uint32_t>(now);
+          const uint64_t tick = now + elapsed;
+          REQUIRE(expiries.count(handle) == 1);
+          REQUIRE(expiries[handle] == tick);
+          REQUIRE(ids[value] == tick);
+          REQUIRE(tick >= last);
+          last = tick;
+          expiries.erase(handle);
+          ids.erase(value);
+        });
+        now += ticks;
+        REQUIRE(wheel.now() == static_cast<uint32_t>(now));
+        REQUIRE(expired == running - expiries.size());
+        for (const auto &[handle, expiry] : expiries)
+          REQUIRE(expiry > now);
+      }
+      REQUIRE(wheel.size() == expiries.size());
+      if (i % 97 == 0)
+      {
+        for (const auto &[handle, expiry] : expiries)
+          REQUIRE(wheel.remaining(handle) == expiry - now);
+      }
+    }
+
+    size_t remaining = expiries.size();
+    REQUIRE(wheel.advance(wheel.max_delay(), [](handle_t, uint32_t) {}) == remaining);
+    REQUIRE(wheel.size() == 0);
+  }
+}
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "esutils/window_statistics.hpp"
+
+namespace
+{
+  constexpr int slidingMin()
+  {
+    esutils::SlidingMin<int, 3> min;
+    for (int x : {5, 3, 4, 6, 7})
+      min.push(x);
+    return min.value();
+  }
+  static_assert(slidingMin() == 4);
+
+  double referenceVariance(const std::deque<double> &window)
+  {
+    double mean = 0;
+    for (double x : window)
+      mean += x;
+    mean /= static_cast<double>(window.size());
+    double squares = 0;
+    for (double x : window)
+      squares += (x - mean) * (x - mean);
+    return squares / static_cast<double>(window.size());
+  }
+}
+
+TEST_CASE("WindowStatistics", "[esutils]")
+{
+  SECTION("Sliding extremum")
+  {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> pick(-1000, 1000);
+    // A window of 300 samples uses 16 bits sequence numbers that wrap around
+    esutils::SlidingMin<int16_t, 300> min;
+    esutils::SlidingMax<int16_t, 300> max;
+    std::deque<int16_t> window;
+    REQUIRE(min.value() == 0);
+    for (int i = 0; i < 200000; ++i)
+    {
+      // Monotonic runs exercise the worst cases of the deque
+      const int16_t x = static_cast<int16_t>(i % 5000 < 1000 ? i % 1000 : pick(rng));
+      min.push(x);
+      max.push(x);
+      window.push_back(x);
+      if (window.size() > 300)
+        window.pop_front();
+      REQUIRE(min.value() == *std::min_element(window.begin(), window.end()));
+      REQUIRE(max.value() == *std::max_element(window.begin(), window.end()));
+    }
+    min.clear();
+    min.push(12);
+    REQUIRE(min.value() == 12);
+  }
+
+  SECTION("Integral samples")
+  {
+    esutils::WindowStatistics<int32_t, 4> stats;
+    REQUIRE(stats.size() == 0);
+    REQUIRE(stats.mean() == 0);
+    REQUIRE(stats.variance() == 0);
+    stats.push(2'000'000'000);
+    REQUIRE(stats.sample_variance() == 0);
+    const int32_t values[4] = {2'000'000'000, -7, 13, 2'000'000'000};
+    stats.push(values, 4);
+    REQUIRE(stats.size() == 4);
+    REQUIRE(stats.sum() == 4'000'000'006);
+    REQUIRE(stats.min() == -7);
+    REQUIRE(stats.max() == 2'000'000'000);
+    REQUIRE(stats.mean() == Catch::Approx(1'000'000'001.5));
+    REQUIRE(stats.variance() == Catch::Approx(1e18).epsilon(1e-8));
+    REQUIRE(stats.sample_variance() == Catch::Approx(4e18 / 3).epsilon(1e-8));
+
+    stats.clear();
+    REQUIRE(stats.size() == 0);
+    stats.push(5);
+    REQUIRE(stats.min() == 5);
+    REQUIRE(stats.max() == 5);
+    REQUIRE(stats.sum() == 5);
+  }
+
+  SECTION("Floating point samples")
+  {
+    std::mt19937 rng(3);
+    std::normal_distribution<double> noise(0, 0.01);
+    esutils::WindowStatistics<double, 64> stats;
+    std::deque<double> window;
+    for (int i = 0; i < 200000; ++i)
+    {
+      // A large offset breaks the naive sum of squares
+      const double x = 1e6 + (i / 20000) * 100 + noise(rng);
+      stats.push(x);
+      window.push_back(x);
+      if (window.size() > 64)
+        window.pop_front();
+      if (i % 997 == 0)
+      {
+        double mean = 0;
+        for (double v : window)
+          mean += v;
+        mean /= static_cast<double>(window.size());
+        REQUIRE(stats.mean() == Catch::Approx(mean).epsilon(1e-12));
+        REQUIRE(stats.variance() == Catch::Approx(referenceVariance(window)).epsilon(1e-4).margin(1e-9));
+      }
+    }
+
+    esutils::WindowStatistics<float, 8> constant;
+    for (int i = 0; i < 1000; ++i)
+      constant.push(0.1f);
+    REQUIRE(constant.variance() >= 0);
+    REQUIRE(constant.variance() < 1e-10f);
+    REQUIRE(constant.sum() == Catch::Approx(0.8f));
+  }
+
+  SECTION("Percentiles")
+  {
+    esutils::WindowStatistics<uint16_t, 1000, 100> stats(0, 999);
+    for (uint16_t i = 0; i < 3000; ++i)
+      stats.push(static_cast<uint16_t>((i * 7) % 1000));
+    // The window holds every value of [0, 999] once
+    REQUIRE(stats.percentile(0.5) == Catch::Approx(500).margin(10));
+    REQUIRE(stats.percentile(0.99) == Catch::Approx(990).margin(10));
+    REQUIRE(stats.percentile(0) == Catch::Approx(0).margin(10));
+    REQUIRE(stats.percentile(1) == Catch::Approx(1000).margin(10));
+
+    std::mt19937 rng(11);
+    std::normal_distribution<float> normal(0, 1);
+    esutils::WindowStatistics<float, 512, 64> gaussian(-4, 4);
+    std::deque<float> window;
+    for (int i = 0; i < 5000; ++i)
+    {
+      const float x = normal(rng);
+      gaussian.push(x);
+      window.push_back(x);
+      if (window.size() > 512)
+        window.pop_front();
+    }
+    std::vector<float> sorted(window.begin(), window.end());
+    std::sort(sorted.begin(), sorted.end());
+    for (float p : {0.1f, 0.5f, 0.9f})
+    {
+      const float expected = sorted[static_cast<size_t>(p * 511)];
+      CAPTURE(p);
+      REQUIRE(std::abs(gaussian.percentile(p) - expected) <= 8.0f / 64);
+    }
+  }
+
+  SECTION("Histogram")
+  {
+    esutils::WindowHistogram<int8_t, 4, 10> histogram(-8, 7);
+    for (int8_t x : {-100, -8, -5, 0, 3, 4, 7, 100})
+      histogram.add(x);
+    REQUIRE(histogram.size() == 8);
+    REQUIRE(histogram.count(0) == 3);
+    REQUIRE(histogram.count(1) == 0);
+    REQUIRE(histogram.count(2) == 2);
+    REQUIRE(histogram.count(3) == 3);
+    // The median is halfway through the bin of 0 and 3
+    REQUIRE(histogram.percentile(0.5) == 2);
+    histogram.remove(100);
+    REQUIRE(histogram.count(3) == 2);
+    histogram.clear();
+    REQUIRE(histogram.size() == 0);
+    REQUIRE(histogram.percentile(0.5) == -8);
+  }
+}